@@ -8,93 +8,1772 @@
 	SLIPEncodedSerial serialSLIP(Serial);
 #endif
 
+#if defined(__AVR__)
+	extern char __heap_start;
+	extern char *__brkval;
+	struct __freelist {
+		size_t sz;
+		struct __freelist *nx;
+		};
+	extern struct __freelist *__flp; // free blocks of avr-libc malloc
+#elif defined(__arm__) && !defined(ESP32) && !defined(__IMXRT1062__)
+	extern "C" char *sbrk(int incr);
+#endif
+
+#if defined(__AVR__) || (defined(__arm__) && !defined(ESP32) && !defined(__IMXRT1062__))
+	#define RAM_PAINT		0xC5 // the heap grows up to the stack, the gap is painted with this
+	#define RAM_MARGIN	64 // bytes below the stack of the painting which are left
+#endif
+
+#if defined(RAM_PAINT)
+static char *heapEnd() {
+	#if defined(__AVR__)
+		return __brkval ? __brkval : &__heap_start;
+	#else
+		return sbrk(0);
+	#endif
+	}
+
+static char *ramPainted; // start of the painted RAM, NULL until the first update()
+#elif !defined(ESP32)
+static uint32_t ramLow; // lowest freeRam() of update()
+#endif
+
+#if EOS_RAM_BUDGET
+static_assert(EOS_RAM_EOS <= EOS_RAM_BUDGET,
+	"EOS needs more RAM than EOS_RAM_BUDGET, reduce EOS_RX_SLOTS, EOS_RX_SLOT_SIZE or EOS_CAPTURE");
+#endif
+#if EOS_RAM_CONTROL
+static_assert(EOS_RAM_ENCODER <= EOS_RAM_CONTROL, "Encoder needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_WHEEL <= EOS_RAM_CONTROL, "Wheel needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_KEY <= EOS_RAM_CONTROL, "Key needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_SUBMASTER <= EOS_RAM_CONTROL, "Submaster needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_FADER <= EOS_RAM_CONTROL, "Fader needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_MACRO <= EOS_RAM_CONTROL, "Macro needs more RAM than EOS_RAM_CONTROL");
+static_assert(EOS_RAM_OSCBUTTON <= EOS_RAM_CONTROL, "OscButton needs more RAM than EOS_RAM_CONTROL");
+#endif
+
+/**
+ * @brief paint the gap between the heap and the stack once, for ramLowWater()
+ * 
+ */
+static void ramPaint() {
+#if defined(RAM_PAINT)
+	if (ramPainted) return;
+	char top;
+	ramPainted = heapEnd();
+	for (volatile char *p = ramPainted; p < &top - RAM_MARGIN; p++) *p = RAM_PAINT;
+#endif
+	}
+
+/**
+ * @brief keep the lowest free RAM where it can't be painted
+ * 
+ */
+static void ramSample() {
+#if !defined(RAM_PAINT) && !defined(ESP32)
+	uint32_t total = freeRam();
+	if (total < ramLow || !ramLow) ramLow = total;
+#endif
+	}
+
+#ifdef EOS_EEPROM
+	#include <EEPROM.h>
+
+/**
+ * @brief the console found by the discovery, stored at EOS_EEPROM_ADDR
+ * 
+ */
+struct EOSCache {
+	uint8_t magic[2];
+	uint8_t ip[4];
+	uint16_t port;
+	uint8_t check;
+	};
+
+static uint8_t cacheCheck(EOSCache& cache) {
+	uint8_t sum = 0xA5;
+	for (uint8_t i = 0; i < 4; i++) sum += cache.ip[i];
+	return sum ^ (cache.port >> 8) ^ (cache.port & 0xFF);
+	}
+
+static bool cacheLoad(IPAddress& ip, uint16_t& port) {
+	EOSCache cache;
+	#if defined(ESP8266) || defined(ESP32)
+		EEPROM.begin(EOS_EEPROM_ADDR + sizeof(EOSCache));
+	#endif
+	EEPROM.get(EOS_EEPROM_ADDR, cache);
+	if (cache.magic[0] != 'e' || cache.magic[1] != 'O' || cache.check != cacheCheck(cache)) return false;
+	ip = IPAddress(cache.ip[0], cache.ip[1], cache.ip[2], cache.ip[3]);
+	port = cache.port;
+	return true;
+	}
+
+static void cacheWrite(EOSCache& cache) {
+	#if defined(ESP8266) || defined(ESP32)
+		EEPROM.begin(EOS_EEPROM_ADDR + sizeof(EOSCache));
+	#endif
+	EEPROM.put(EOS_EEPROM_ADDR, cache);
+	#if defined(ESP8266) || defined(ESP32)
+		EEPROM.commit();
+	#endif
+	}
+
+static void cacheStore(IPAddress ip, uint16_t port) {
+	IPAddress cachedIP;
+	uint16_t cachedPort;
+	if (cacheLoad(cachedIP, cachedPort) && cachedIP == ip && cachedPort == port) return; // spare the EEPROM
+	EOSCache cache = {{'e', 'O'}, {ip[0], ip[1], ip[2], ip[3]}, port, 0};
+	cache.check = cacheCheck(cache);
+	cacheWrite(cache);
+	}
+
+static void cacheClear() {
+	EOSCache cache = {{0, 0}, {0, 0, 0, 0}, 0, 0};
+	cacheWrite(cache);
+	}
+#else
+static bool cacheLoad(IPAddress& ip, uint16_t& port) {return false;}
+static void cacheStore(IPAddress ip, uint16_t port) {}
+static void cacheClear() {}
+#endif
+
+
+static const uint8_t eot = 0300;
+static const uint8_t slipesc = 0333;
+static const uint8_t slipescend = 0334;
+static const uint8_t slipescesc = 0335;
+
+/**
+ * @brief a message or bundle is encoded as a TCP frame, into the coalescing buffer
+ * or, if it is too large, streamed through the buffer to the client,
+ * without a buffer only the size is counted
+ * 
+ */
+class EOSFrame : public Print {
+	public:
+		EOSFrame(framing_t framing, uint8_t *buffer, uint16_t size, Client *out = NULL) {
+			this->framing = framing;
+			this->buffer = buffer;
+			this->size = size;
+			this->out = out;
+			overflow = false;
+			written = 0;
+			}
+		void begin(uint32_t length = 0) {
+			if (!buffer) return;
+			if (framing == TCP_SLIP) put(eot);
+			else {
+				lengthAt = size;
+				for (int8_t i = 24; i >= 0; i -= 8) put(length >> i);
+				}
+			}
+		void end() {
+			if (!buffer) return;
+			if (framing == TCP_SLIP) put(eot);
+			else if (!out && !overflow) {
+				uint32_t length = size - lengthAt - 4;
+				for (uint8_t i = 0; i < 4; i++) buffer[lengthAt + i] = length >> (24 - 8 * i);
+				}
+			}
+		using Print::write;
+		size_t write(uint8_t c) {
+			if (framing == TCP_SLIP && buffer && (c == eot || c == slipesc)) {
+				put(slipesc);
+				c = c == eot ? slipescend : slipescesc;
+				}
+			put(c);
+			return 1;
+			}
+		uint8_t *buffer;
+		uint16_t size;
+		bool overflow;
+		uint32_t written; // bytes streamed to the client
+	private:
+		void put(uint8_t c) {
+			if (!buffer) {
+				size++;
+				return;
+				}
+			if (size == EOS_TCP_TX_SIZE) {
+				if (!out) {
+					overflow = true;
+					return;
+					}
+				out->write(buffer, size);
+				written += size;
+				size = 0;
+				}
+			buffer[size++] = c;
+			}
+		framing_t framing;
+		Client *out;
+		uint16_t lengthAt;
+	};
+
+/**
+ * @brief a message or bundle is encoded once into this buffer and then sent to all consoles
+ * 
+ */
+class EOSPacket : public Print {
+	public:
+		EOSPacket(uint8_t *buffer) {
+			this->buffer = buffer;
+			size = 0;
+			overflow = false;
+			}
+		using Print::write;
+		size_t write(uint8_t c) {
+			if (size < EOS_TX_SIZE) buffer[size++] = c;
+			else overflow = true;
+			return 1;
+			}
+		uint8_t *buffer;
+		uint16_t size;
+		bool overflow;
+	};
+
+/**
+ * @brief counts the bytes of a packet on the way to the interface
+ * 
+ */
+class EOSCount : public Print {
+	public:
+		EOSCount(Print &out) : out(out) {
+			size = 0;
+			}
+		using Print::write;
+		size_t write(uint8_t c) {
+			size++;
+			return out.write(c);
+			}
+		size_t write(const uint8_t *buffer, size_t size) {
+			this->size += size;
+			return out.write(buffer, size);
+			}
+		Print &out;
+		uint32_t size;
+	};
+
+#if EOS_CAPTURE
+/**
+ * @brief ring of captured packets, each record is the micros() as uint32, the size as uint16,
+ * the flags (EOS_CAPTURE_TX, index of the console) and the packet, little endian,
+ * a packet is written as it is encoded and the oldest records are dropped for it
+ * 
+ */
+class EOSCapture : public Print {
+	public:
+		EOSCapture() {
+			head = fill = pending = 0;
+			drops = 0;
+			overflow = false;
+			}
+		void begin(uint8_t flags) {
+			pending = 0;
+			overflow = false;
+			uint32_t time = clockMicros();
+			for (uint8_t i = 0; i < 4; i++) put(time >> (8 * i));
+			put(0);
+			put(0);
+			put(flags);
+			}
+		void end() {
+			uint32_t size = pending - 7;
+			if (overflow || size > 0xFFFF) return; // doesn't fit, only the dropped records are gone
+			ring[(head + fill + 4) % EOS_CAPTURE] = size;
+			ring[(head + fill + 5) % EOS_CAPTURE] = size >> 8;
+			fill += pending;
+			}
+		void record(uint8_t flags, const uint8_t *packet, uint16_t size) {
+			begin(flags);
+			while (size--) put(*packet++);
+			end();
+			}
+		using Print::write;
+		size_t write(uint8_t c) {
+			put(c);
+			return 1;
+			}
+		void dump(Print &out, uint32_t from, uint32_t size) {
+			from = (head + from) % EOS_CAPTURE;
+			uint32_t first = EOS_CAPTURE - from;
+			if (first > size) first = size;
+			out.write(ring + from, first);
+			out.write(ring, size - first);
+			}
+		uint32_t recordSize(uint32_t at) {
+			at += head;
+			return 7 + (ring[(at + 4) % EOS_CAPTURE] | ring[(at + 5) % EOS_CAPTURE] << 8);
+			}
+		uint32_t head;
+		uint32_t fill;
+		uint16_t drops;
+	private:
+		void put(uint8_t c) {
+			if (overflow) return;
+			while (fill + pending >= EOS_CAPTURE) {
+				if (fill == 0) {
+					overflow = true;
+					return;
+					}
+				uint32_t size = recordSize(0);
+				head = (head + size) % EOS_CAPTURE;
+				fill -= size;
+				drops++;
+				}
+			ring[(head + fill + pending++) % EOS_CAPTURE] = c;
+			}
+		uint8_t ring[EOS_CAPTURE];
+		uint32_t pending; // bytes of the record in progress
+		bool overflow;
+	};
+#endif
+
+#if EOS_PROFILE
+struct ProfileStats {
+	uint32_t count;
+	uint32_t low;
+	uint32_t high;
+	uint64_t sum;
+	};
+
+static ProfileStats profileStats[PROFILE_STAGES];
+static ProfileStats profileLoops;
+static uint32_t profileBins[EOS_PROFILE_BINS];
+static uint8_t profileDepth[PROFILE_STAGES]; // a stage which calls itself, e.g. a send, is measured once
+static uint32_t profileLoopTime;
+static bool profileStarted;
+static EOS *profileOwner; // the first EOS object whose update() runs measures the loop
+static const char *const profileNames[PROFILE_STAGES] = {
+	"update", "receive", "parse", "send",
+	"encoder", "wheel", "key", "submaster", "fader", "macro", "oscbutton",
+	"display", "user"
+	};
+
+static void profileAdd(ProfileStats &stats, uint32_t time) {
+	if (!stats.count || time < stats.low) stats.low = time;
+	if (time > stats.high) stats.high = time;
+	stats.sum += time;
+	stats.count++;
+	}
+
+static uint32_t profileAverage(ProfileStats &stats) {
+	return stats.count ? stats.sum / stats.count : 0;
+	}
+
+static void profileLoop() {
+	uint32_t now = clockMicros();
+	if (profileStarted) {
+		uint32_t time = now - profileLoopTime;
+		profileAdd(profileLoops, time);
+		uint8_t bin = 0;
+		for (uint32_t limit = 64; time >= limit && bin < EOS_PROFILE_BINS - 1; limit <<= 1) bin++;
+		profileBins[bin]++;
+		}
+	profileLoopTime = now;
+	profileStarted = true;
+	}
+
+Profile::Profile(profile_t stage) {
+	this->stage = stage;
+	if (profileDepth[stage]++ == 0) start = clockMicros();
+	}
+
+Profile::~Profile() {
+	if (--profileDepth[stage] == 0) profileAdd(profileStats[stage], clockMicros() - start);
+	}
+#endif
+
+#if EOS_LATENCY
+static uint16_t latencyBins[LATENCY_CLASSES][EOS_LATENCY_BINS];
+static uint32_t latencyHigh[LATENCY_CLASSES];
+static uint32_t latencyTime; // micros() of the input edge
+static latency_t latencyClass;
+static bool latencyPending; // an edge waits for its send
+static const char *const latencyNames[LATENCY_CLASSES] = {
+	"encoder", "wheel", "key", "submaster", "fader", "macro", "oscbutton"
+	};
+#endif
+
+#if EOS_LATENCY
+static bool latencyUsed(uint8_t type) {
+	for (uint8_t i = 0; i < EOS_LATENCY_BINS; i++) {
+		if (latencyBins[type][i]) return true;
+		}
+	return false;
+	}
+#endif
+
+// a control detected an input, its message is on the way
+static inline void latencyEdge(latency_t type) {
+#if EOS_LATENCY
+	latencyTime = clockMicros();
+	latencyClass = type;
+	latencyPending = true;
+#endif
+	}
+
+// the message of the input was sent, queued or dropped
+static inline void latencyEnd() {
+#if EOS_LATENCY
+	latencyPending = false;
+#endif
+	}
+
+// the first packet of the input is on the wire
+static inline void latencySent() {
+#if EOS_LATENCY
+	if (!latencyPending) return;
+	latencyPending = false;
+	uint32_t time = clockMicros() - latencyTime;
+	uint8_t bin = 0;
+	for (uint32_t limit = 16; time >= limit && bin < EOS_LATENCY_BINS - 1; limit <<= 1) bin++;
+	if (latencyBins[latencyClass][bin] < 0xFFFF) latencyBins[latencyClass][bin]++;
+	if (time > latencyHigh[latencyClass]) latencyHigh[latencyClass] = time;
+#endif
+	}
+
+static EOS *initTarget = NULL; // the EOS object which runs its init, the helpers without a target send to it
+static const LinkEdge *sendingEdge = NULL; // the button edge of the message which is sent, see sendEdge()
 
 EOS::EOS(UDP &udp, IPAddress ip, uint16_t port, interface_t interface) {
 	this->udp = &udp;
 	this->interface = interface;
-	this->ip = ip;
-	this->port = port;
+	initState();
+	dests[0].ip = ip;
+	dests[0].port = port;
+	}
+
+EOS::EOS(Client &client, IPAddress ip, uint16_t port, framing_t framing) {
+	this->client = &client;
+	this->interface = EOSTCP;
+	initState();
+	tcp = new TcpState;
+	tcp->fill = 0;
+	tcp->time = tcp->retry = 0;
+	tcp->framing = framing;
+	tcp->escape = false;
+	tcp->header = 0;
+	tcp->length = 0;
+	reconnectState(); // button edges are kept while the connection is down
+	dests[0].ip = ip;
+	dests[0].port = port;
 	}
 
 EOS::EOS(interface_t interface) {
 	this->interface = interface;
+	initState();
+	}
+
+void EOS::initState() {
+	dests = &console;
+	destCount = 1;
+	initDestination(console);
+	txBuffer = NULL;
+	rxHead = rxCount = rxHigh = 0;
+	rxDrops = rxFill = 0;
+	rxOverflow = false;
+	bundle = NULL;
+	bootTimeHook = NULL;
+	bootPending = false;
+	bootMs = 0;
+	linkState = NULL;
+	initFunction = NULL;
+	linkUp = true;
+	reconnect = NULL;
+	pingName = "eOS";
+	pingSeq = 0;
+	discovery = DISCOVERY_OFF;
+	transports = NULL;
+	transportCount = 0;
+	transportPolicy = FAILOVER;
+	tcp = NULL;
+	tcpUp = interface != EOSTCP;
+	captureRing = NULL;
+	captureOn = false;
+	txPacketCount = txByteCount = rxPacketCount = rxByteCount = 0;
+	loopCount = loopsPerSecond = uptime = 0;
+	rateTime = clockMillis();
+	firmwareVersion = "";
+	publish = NULL;
+	replyOut = NULL;
+	}
+
+void EOS::initDestination(Destination &dest) {
+	dest.port = 0;
+	dest.connected = dest.dead = dest.pingPending = false;
+	dest.wasLost = true; // the first answer gets the init, also without a link check
+	dest.pingSeq = 0;
+	dest.rxTime = dest.pingTime = dest.pingMicros = 0;
+	dest.pingCount = dest.pingLost = dest.rttCount = 0;
+	dest.rttLow = dest.rttHigh = dest.rttSum = 0;
+	}
+
+EOS::Reconnect &EOS::reconnectState() {
+	if (!reconnect) {
+		reconnect = new Reconnect;
+		reconnect->linkCheckTime = reconnect->linkLostTime = reconnect->reconnectMs = 0;
+		reconnect->linkDrops = 0;
+		reconnect->linkQueued = 0;
+		reconnect->discoveryPort = 8000;
+		reconnect->probeTime = 0;
+		}
+	return *reconnect;
+	}
+
+bool EOS::addDestination(IPAddress ip, uint16_t port) {
+	if (interface != EOSUDP || destCount == EOS_DESTINATIONS) return false;
+	if (!txBuffer) txBuffer = new uint8_t[EOS_TX_SIZE];
+	if (dests == &console) {
+		dests = new Destination[EOS_DESTINATIONS];
+		dests[0] = console;
+		for (uint8_t i = 1; i < EOS_DESTINATIONS; i++) initDestination(dests[i]);
+		}
+	dests[destCount].ip = ip;
+	dests[destCount].port = port;
+	destCount++;
+	return true;
+	}
+
+uint8_t EOS::destinations() {
+	return destCount;
 	}
 
 void EOS::sendOSC(OSCMessage& msg, IPAddress ip, uint16_t port) {
+	sendPacket(msg, ip, port);
+	}
+
+void EOS::sendOSC(OSCMessage& msg) {
+	if (transportCount && !bundle) {
+		if (transportPolicy == MIRROR) {
+			for (uint8_t i = 0; i < transportCount; i++) transports[i]->sendOSC(msg);
+			}
+		else {
+			uint8_t active = transport();
+			if (active) {
+				transports[active - 1]->sendOSC(msg);
+				return;
+				}
+			}
+		}
+	sendLocal(msg);
+	}
+
+void EOS::sendOSC(OSCMessage& msg, uint8_t transport) {
+	if (transport == EOS_ANY || transport > transportCount) sendOSC(msg);
+	else if (transport) transports[transport - 1]->sendOSC(msg);
+	else sendLocal(msg);
+	}
+
+void EOS::sendLocal(OSCMessage& msg) {
+	if (bundle) {
+		bundle->add(msg);
+		return;
+		}
+	if (!linkUp || !tcpUp || discovery == DISCOVERY_SEARCH) {
+		// keep button edges for the reconnect, continuous values are outdated then
+		Reconnect &state = reconnectState();
+		if (sendingEdge && state.linkQueued < EOS_LINK_QUEUE) state.linkQueue[state.linkQueued++] = *sendingEdge;
+		else state.linkDrops++;
+		return;
+		}
+	sendAll(msg, 0xFF);
+	if (bootPending) {
+		bootPending = false;
+		bootMs = clockMillis();
+		if (bootTimeHook) bootTimeHook(bootMs);
+		}
+	}
+
+void EOS::sendPacket(OSCMessage& msg, IPAddress ip, uint16_t port) {
+	Profile profile(PROFILE_SEND);
+	captureTx(msg, ip);
 	if (interface == EOSUDP) {
 		udp->beginPacket(ip, port);
-		msg.send(*udp);
+		EOSCount out(*udp);
+		msg.send(out);
 		udp->endPacket();
+		txPacketCount++;
+		txByteCount += out.size;
 		}	
 	if (interface == EOSUSB) {
 		serialSLIP.beginPacket();
-		msg.send(serialSLIP);
+		EOSCount out(serialSLIP);
+		msg.send(out);
 		serialSLIP.endPacket();
+		txPacketCount++;
+		txByteCount += out.size;
 		}
+	if (interface == EOSTCP) tcpSend(msg);
+	latencySent();
 	}
 
-void EOS::sendOSC(OSCMessage& msg) {
+void EOS::sendPacket(OSCBundle& bundle, IPAddress ip, uint16_t port) {
+	Profile profile(PROFILE_SEND);
+	captureTx(bundle, ip);
 	if (interface == EOSUDP) {
 		udp->beginPacket(ip, port);
-		msg.send(*udp);
+		EOSCount out(*udp);
+		bundle.send(out);
 		udp->endPacket();
-		}	
+		txPacketCount++;
+		txByteCount += out.size;
+		}
 	if (interface == EOSUSB) {
 		serialSLIP.beginPacket();
-		msg.send(serialSLIP);
+		EOSCount out(serialSLIP);
+		bundle.send(out);
 		serialSLIP.endPacket();
+		txPacketCount++;
+		txByteCount += out.size;
+		}
+	if (interface == EOSTCP) tcpSend(bundle);
+	latencySent();
+	}
+
+template <typename T> void EOS::tcpSend(T& packet) {
+	if (!tcpUp) return;
+	txPacketCount++;
+	EOSFrame frame(tcp->framing, tcp->tx, tcp->fill);
+	frame.begin();
+	packet.send(frame);
+	frame.end();
+	if (frame.overflow) {
+		// too large for the rest of the buffer, send the buffer and stream the packet through it
+		tcpFlush();
+		uint32_t length = 0;
+		if (tcp->framing == TCP_LENGTH) {
+			EOSFrame count(tcp->framing, NULL, 0);
+			packet.send(count);
+			length = count.size;
+			}
+		frame = EOSFrame(tcp->framing, tcp->tx, 0, client);
+		frame.begin(length);
+		packet.send(frame);
+		frame.end();
+		txByteCount += frame.written;
+		}
+	if (tcp->fill == 0) tcp->time = clockMillis();
+	tcp->fill = frame.size;
+	if (EOS_TCP_COALESCE_MS == 0) tcpFlush();
+	}
+
+void EOS::tcpFlush() {
+	if (tcp->fill) client->write(tcp->tx, tcp->fill);
+	txByteCount += tcp->fill;
+	tcp->fill = 0;
+	}
+
+void EOS::tcpUpdate() {
+	if (!linkUp) return;
+	if (!client->connected()) {
+		if (tcpUp) {
+			// the connection is lost, button edges are kept like with a lost link
+			tcpUp = false;
+			tcp->fill = 0;
+			tcp->header = 0;
+			tcp->escape = false;
+			rxFill = 0;
+			rxOverflow = false;
+			if (dests[0].connected) dests[0].wasLost = true;
+			dests[0].connected = false;
+			dests[0].pingPending = false;
+			}
+		if ((clockMillis() - tcp->retry) >= EOS_TCP_RETRY_MS) {
+			tcp->retry = clockMillis();
+			client->stop();
+			client->connect(dests[0].ip, dests[0].port); // doesn't block with setConnectionTimeout(0) of Ethernet3
+			}
+		return;
+		}
+	if (!tcpUp) {
+		tcpUp = true;
+		reinit();
+		replayQueue();
+		}
+	if (tcp->fill && (clockMillis() - tcp->time) >= EOS_TCP_COALESCE_MS) tcpFlush();
+	}
+
+template <typename T> void EOS::sendAll(T& packet, uint8_t mask) {
+	Profile profile(PROFILE_SEND);
+	if (destCount == 1) {
+		if ((mask & 1) && reachable(0)) sendPacket(packet, dests[0].ip, dests[0].port);
+		return;
+		}
+	// one encode, then only the socket sends for each console
+	EOSPacket encoded(txBuffer);
+	packet.send(encoded);
+	for (uint8_t i = 0; i < destCount; i++) {
+		// a dead console would block the others with the ARP timeout of each send
+		if (!(mask & (1 << i)) || !reachable(i)) continue;
+		if (encoded.overflow) {
+			sendPacket(packet, dests[i].ip, dests[i].port); // too large for the buffer
+			continue;
+			}
+#if EOS_CAPTURE
+		if (captureOn) captureRing->record(EOS_CAPTURE_TX | i, encoded.buffer, encoded.size);
+#endif
+		udp->beginPacket(dests[i].ip, dests[i].port);
+		udp->write(encoded.buffer, encoded.size);
+		udp->endPacket();
+		txPacketCount++;
+		txByteCount += encoded.size;
+		latencySent();
+		}
+	}
+
+template <typename T> void EOS::captureTx(T& packet, IPAddress ip) {
+#if EOS_CAPTURE
+	if (!captureOn) return;
+	uint8_t index = 0;
+	for (uint8_t i = 1; i < destCount; i++) {
+		if (ip == dests[i].ip) index = i;
+		}
+	captureRing->begin(EOS_CAPTURE_TX | index);
+	packet.send(*captureRing);
+	captureRing->end();
+#endif
+	}
+
+bool EOS::reachable(uint8_t index) {
+	if (index == 0 && discovery == DISCOVERY_SEARCH) return false; // not found yet
+	return destCount == 1 || !dests[index].dead;
+	}
+
+void EOS::beginBundle() {
+	if (!bundle) bundle = new OSCBundle;
+	}
+
+void EOS::endBundle() {
+	initSend(0xFF);
+	}
+
+void EOS::initSend(uint8_t mask) {
+	if (!bundle) return;
+	sendAll(*bundle, mask);
+	delete bundle;
+	bundle = NULL;
+	for (uint8_t i = 0; i < destCount; i++) {
+		if ((mask & (1 << i)) && reachable(i)) dests[i].wasLost = false; // has the init again
 		}
+	if (!bootMs) bootPending = true; // only the first init
+	}
+
+void EOS::runInit(uint8_t mask) {
+	if (!initFunction) return;
+	EOS *last = initTarget;
+	initTarget = this;
+	beginBundle();
+	initFunction();
+	initSend(mask);
+	initTarget = last;
+	}
+
+void EOS::bootHook(void (*hook)(uint32_t bootTime)) {
+	bootTimeHook = hook;
+	}
+
+uint32_t EOS::bootTime() {
+	return bootMs;
+	}
+
+void EOS::linkCheck(bool (*check)()) {
+	reconnectState();
+	linkState = check;
+	linkUp = false; // the first check sends the init
+	}
+
+void EOS::initHook(void (*init)()) {
+	initFunction = init;
+	}
+
+void EOS::update() {
+#if EOS_PROFILE
+	if (!profileOwner) profileOwner = this;
+	if (profileOwner == this) profileLoop();
+#endif
+	Profile profile(PROFILE_UPDATE);
+	ramPaint(); // once, after setup() and the constructors have allocated
+	ramSample();
+	loopCount++;
+	uint32_t elapsed = clockMillis() - rateTime;
+	if (elapsed >= 1000) {
+		loopsPerSecond = (uint64_t)loopCount * 1000 / elapsed;
+		loopCount = 0;
+		uptime += elapsed / 1000;
+		rateTime = clockMillis() - elapsed % 1000; // the rest counts for the next second
+		}
+	if (publish && publish->interval && (clockMillis() - publish->time) >= publish->interval) {
+		publish->time = clockMillis();
+		if (publish->port) sendStatus(publish->ip, publish->port);
+		else sendStatus(dests[0].ip, dests[0].port);
+		}
+	for (uint8_t i = 0; i < transportCount; i++) transports[i]->update();
+	if (interface == EOSTCP) tcpUpdate();
+	connectionUpdate();
+	if (!linkState || (clockMillis() - reconnect->linkCheckTime) < EOS_LINK_CHECK_MS) return;
+	reconnect->linkCheckTime = clockMillis();
+	bool state = linkState();
+	if (state == linkUp) return;
+	linkUp = state;
+	if (!linkUp) {
+		reconnect->linkLostTime = reconnect->linkCheckTime;
+		for (uint8_t i = 0; i < destCount; i++) {
+			if (dests[i].connected) dests[i].wasLost = true;
+			dests[i].connected = false;
+			dests[i].pingPending = false;
+			}
+		return;
+		}
+	reinit();
+	if (discovery != DISCOVERY_SEARCH && tcpUp) replayQueue(); // else when the console is found or connected
+	if (reconnect->linkLostTime) reconnect->reconnectMs = clockMillis() - reconnect->linkLostTime;
+	}
+
+void EOS::replayQueue() {
+	if (!reconnect) return;
+	for (uint8_t i = 0; i < reconnect->linkQueued; i++) {
+		LinkEdge &edge = reconnect->linkQueue[i];
+		OSCMessage msg;
+		edge.message(edge.control, edge.value, msg);
+		sendAll(msg, 0xFF);
+		}
+	reconnect->linkQueued = 0;
+	}
+
+void EOS::reinit() {
+	runInit(0xFF);
+	}
+
+uint8_t EOS::addTransport(EOS &transport) {
+	if (transportCount == EOS_TRANSPORTS || &transport == this) return 0;
+	if (!transports) transports = new EOS*[EOS_TRANSPORTS];
+	transports[transportCount++] = &transport;
+	return transportCount;
 	}
 
-extern EOS eos;
+void EOS::policy(policy_t policy) {
+	transportPolicy = policy;
+	}
+
+uint8_t EOS::transport() {
+	if (linkUp && connected()) return 0;
+	for (uint8_t i = 0; i < transportCount; i++) {
+		if (transports[i]->link() && transports[i]->connected()) return i + 1;
+		}
+	return 0; // nothing is healthy, stay with this one
+	}
+
+bool EOS::link() {
+	return linkUp;
+	}
+
+uint32_t EOS::reconnectTime() {
+	return reconnect ? reconnect->reconnectMs : 0;
+	}
+
+uint16_t EOS::linkDropped() {
+	return reconnect ? reconnect->linkDrops : 0;
+	}
+
+void EOS::connectionUpdate() {
+	if (!linkUp || !tcpUp) return;
+	uint32_t now = clockMillis();
+	for (uint8_t i = 0; i < destCount; i++) {
+		Destination &dest = dests[i];
+		if (i == 0 && discovery == DISCOVERY_SEARCH) {
+			if ((now - reconnect->probeTime) >= EOS_DISCOVERY_MS) {
+				reconnect->probeTime = now;
+				OSCMessage probe("/eos/ping");
+				probe.add(pingName.c_str());
+				probe.add(++pingSeq);
+				sendPacket(probe, IPAddress(255, 255, 255, 255), reconnect->discoveryPort);
+				}
+			continue;
+			}
+		if (dest.pingPending && (now - dest.pingTime) > EOS_TIMEOUT_MS) {
+			dest.pingPending = false;
+			dest.pingLost++;
+			dest.dead = true;
+			if (i == 0 && discovery == DISCOVERY_CACHED) search(); // the cached console is gone
+			}
+		if (dest.connected) {
+			uint32_t idle = now - dest.rxTime;
+			if (idle > EOS_TIMEOUT_MS) {
+				dest.connected = false;
+				dest.wasLost = true;
+				}
+			// the console could be idle, ask if it is still there
+			else if (idle > EOS_PING_AFTER_MS && !dest.pingPending && (now - dest.pingTime) > EOS_PING_AFTER_MS) sendPing(dest);
+			}
+		// look for the console, e.g. after a restart, on USB EOS sends the handshake again
+		// when it comes back and the box must not send before
+		else if (interface != EOSUSB && !dest.pingPending && (now - dest.pingTime) > EOS_TIMEOUT_MS) sendPing(dest);
+		}
+	}
+
+void EOS::sendPing(Destination& dest) {
+	// the name and a sequence number come back with /eos/out/ping
+	OSCMessage ping("/eos/ping");
+	ping.add(pingName.c_str());
+	ping.add(++pingSeq);
+	dest.pingSeq = pingSeq;
+	dest.pingTime = clockMillis();
+	dest.pingMicros = clockMicros();
+	dest.pingPending = true;
+	dest.pingCount++;
+	sendPacket(ping, dest.ip, dest.port);
+	}
+
+bool EOS::pingEcho(OSCMessage& msg, Destination& dest) {
+	if (!msg.fullMatch("/eos/out/ping") || msg.size() < 2 || !msg.isInt(1)) return false;
+	char name[32];
+	if (!msg.isString(0) || msg.getString(0, name, sizeof(name)) == 0 || pingName != name) return false;
+	if (dest.pingPending && msg.getInt(1) == dest.pingSeq) {
+		uint32_t rtt = clockMicros() - dest.pingMicros;
+		if (dest.rttCount == 0 || rtt < dest.rttLow) dest.rttLow = rtt;
+		if (rtt > dest.rttHigh) dest.rttHigh = rtt;
+		dest.rttSum += rtt;
+		dest.rttCount++;
+		dest.pingPending = false;
+		}
+	return true; // our own ping, late answers too
+	}
+
+void EOS::pingMessage(String message) {
+	pingName = message;
+	}
+
+bool EOS::connected() {
+	for (uint8_t i = 0; i < destCount; i++) {
+		if (dests[i].connected) return true;
+		}
+	return false;
+	}
+
+bool EOS::connected(uint8_t index) {
+	return index < destCount && dests[index].connected;
+	}
+
+uint8_t EOS::active() {
+	for (uint8_t i = 0; i < destCount; i++) {
+		if (dests[i].connected) return i;
+		}
+	return 0;
+	}
+
+void EOS::discover(uint16_t port) {
+	if (interface != EOSUDP) return;
+	reconnectState().discoveryPort = port;
+	if (cacheLoad(dests[0].ip, dests[0].port)) {
+		// try the cached console first, the first ping goes at once
+		discovery = DISCOVERY_CACHED;
+		dests[0].pingTime = clockMillis() - EOS_TIMEOUT_MS - 1;
+		return;
+		}
+	search();
+	}
+
+void EOS::search() {
+	discovery = DISCOVERY_SEARCH;
+	dests[0].connected = false;
+	dests[0].pingPending = false;
+	reconnect->probeTime = clockMillis() - EOS_DISCOVERY_MS; // the first probe at once
+	}
+
+void EOS::probeReply(uint8_t *packet, uint16_t size) {
+	OSCMessage msg;
+	msg.fill(packet, size);
+	char name[32];
+	if (!msg.fullMatch("/eos/out/ping") || !msg.isString(0)) return;
+	if (msg.getString(0, name, sizeof(name)) == 0 || pingName != name) return;
+	// the first console which answers is used
+	dests[0].ip = udp->remoteIP();
+	dests[0].port = reconnect->discoveryPort;
+	dests[0].dead = false;
+	dests[0].wasLost = true; // gets the init with this packet
+	discovery = DISCOVERY_OFF;
+	cacheStore(dests[0].ip, dests[0].port);
+	}
+
+bool EOS::discovering() {
+	return discovery == DISCOVERY_SEARCH;
+	}
+
+IPAddress EOS::consoleIP() {
+	return dests[0].ip;
+	}
+
+void EOS::forget() {
+	cacheClear();
+	}
+
+uint32_t EOS::rttMin(uint8_t index) {
+	return index < destCount ? dests[index].rttLow : 0;
+	}
+
+uint32_t EOS::rttAvg(uint8_t index) {
+	if (index >= destCount || dests[index].rttCount == 0) return 0;
+	return dests[index].rttSum / dests[index].rttCount;
+	}
+
+uint32_t EOS::rttMax(uint8_t index) {
+	return index < destCount ? dests[index].rttHigh : 0;
+	}
+
+uint16_t EOS::pingsSent(uint8_t index) {
+	return index < destCount ? dests[index].pingCount : 0;
+	}
+
+uint16_t EOS::pingsLost(uint8_t index) {
+	return index < destCount ? dests[index].pingLost : 0;
+	}
+
+uint8_t EOS::pingLoss(uint8_t index) {
+	if (index >= destCount || dests[index].pingCount == 0) return 0;
+	return (uint32_t)dests[index].pingLost * 100 / dests[index].pingCount;
+	}
+
+uint32_t EOS::txPackets() {
+	return txPacketCount;
+	}
+
+uint32_t EOS::txBytes() {
+	return txByteCount;
+	}
+
+uint32_t EOS::rxPackets() {
+	return rxPacketCount;
+	}
+
+uint32_t EOS::rxBytes() {
+	return rxByteCount;
+	}
+
+uint32_t EOS::loopRate() {
+	return loopsPerSecond;
+	}
+
+void EOS::firmware(const char *version) {
+	firmwareVersion = version;
+	}
+
+void EOS::statusPublish(uint32_t interval) {
+	statusPublish(interval, IPAddress(0, 0, 0, 0), 0); // port 0 follows the console, e.g. after the discovery
+	}
+
+void EOS::statusPublish(uint32_t interval, IPAddress ip, uint16_t port) {
+	if (!publish) publish = new Publish;
+	publish->interval = interval;
+	publish->time = clockMillis();
+	publish->ip = ip;
+	publish->port = port;
+	}
+
+void EOS::sendStatus(IPAddress ip, uint16_t port) {
+	// one bundle with a message for each value, the addresses have a common root
+	char address[24];
+	strcpy(address, "/eos-box/status/");
+	char *name = address + strlen(address);
+	replyBegin(ip, port);
+	strcpy(name, "version");
+	OSCMessage version(address);
+	version.add(EOS_VERSION).add(firmwareVersion);
+	replyAdd(version);
+	strcpy(name, "uptime");
+	OSCMessage up(address);
+	up.add((int32_t)uptime);
+	replyAdd(up);
+	strcpy(name, "boot");
+	OSCMessage boot(address);
+	boot.add((int32_t)bootMs);
+	replyAdd(boot);
+	strcpy(name, "loop");
+	OSCMessage loop(address);
+	loop.add((int32_t)loopsPerSecond);
+	replyAdd(loop);
+	strcpy(name, "ram");
+	OSCMessage ram(address);
+	ram.add((int32_t)freeRam()).add((int32_t)heapFragmentation()).add((int32_t)ramLowWater());
+	replyAdd(ram);
+	strcpy(name, "tx");
+	OSCMessage tx(address);
+	tx.add((int32_t)txPacketCount).add((int32_t)txByteCount);
+	replyAdd(tx);
+	strcpy(name, "rx");
+	OSCMessage rx(address);
+	rx.add((int32_t)rxPacketCount).add((int32_t)rxByteCount);
+	replyAdd(rx);
+	strcpy(name, "drops");
+	OSCMessage drops(address);
+	drops.add((int32_t)rxDrops).add((int32_t)linkDropped());
+	replyAdd(drops);
+	strcpy(name, "queues");
+	OSCMessage queues(address);
+	queues.add((int32_t)rxHigh).add((int32_t)(reconnect ? reconnect->linkQueued : 0)).add((int32_t)(tcp ? tcp->fill : 0));
+	replyAdd(queues);
+	strcpy(name, "rtt");
+	OSCMessage rtt(address);
+	rtt.add((int32_t)rttMin()).add((int32_t)rttAvg()).add((int32_t)rttMax()).add((int32_t)pingLoss());
+	replyAdd(rtt);
+	replyEnd();
+	}
+
+void EOS::replyBegin(IPAddress ip, uint16_t port) {
+	// the bundle is written while the messages are made, so it needs no buffer
+	static const uint8_t header[16] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0, 0, 0, 1};
+	replyOut = NULL;
+	if (interface == EOSUDP) {
+		udp->beginPacket(ip, port);
+		replyOut = udp;
+		}
+	if (interface == EOSUSB) {
+		serialSLIP.beginPacket();
+		replyOut = &serialSLIP;
+		}
+	if (replyOut) txByteCount += replyOut->write(header, sizeof(header));
+	}
+
+void EOS::replyAdd(OSCMessage& msg) {
+	if (!replyOut) {
+		tcpSend(msg); // TCP has no bundle on the stream, each message is a packet
+		return;
+		}
+	uint32_t size = msg.bytes();
+	uint8_t length[4] = {(uint8_t)(size >> 24), (uint8_t)(size >> 16), (uint8_t)(size >> 8), (uint8_t)size};
+	replyOut->write(length, 4);
+	msg.send(*replyOut);
+	txByteCount += 4 + size;
+	}
+
+void EOS::replyEnd() {
+	if (interface == EOSUDP) udp->endPacket();
+	if (interface == EOSUSB) serialSLIP.endPacket();
+	if (replyOut) txPacketCount++;
+	if (interface == EOSTCP) tcpFlush();
+	replyOut = NULL;
+	}
+
+/**
+ * @brief compare the address of a packet, with its terminating zero
+ * 
+ */
+static bool isAddress(uint8_t *packet, uint16_t size, const char *address) {
+	uint16_t length = strlen(address) + 1;
+	return size >= length && memcmp(packet, address, length) == 0;
+	}
+
+bool EOS::boxQuery(uint8_t *packet, uint16_t size) {
+	if (size < 12 || memcmp(packet, "/eos-box/", 9) != 0) return false; // the most packets
+	if (isAddress(packet, size, "/eos-box/status")) {
+		if (interface == EOSUDP) sendStatus(udp->remoteIP(), udp->remotePort());
+		else sendStatus(dests[0].ip, dests[0].port);
+		return true;
+		}
+#if EOS_PROFILE
+	if (isAddress(packet, size, "/eos-box/stats/reset")) {
+		profileReset();
+		return true;
+		}
+	if (isAddress(packet, size, "/eos-box/stats")) {
+		// count min avg max in us for the loop and each measured stage, then the histogram of the loop
+		OSCMessage loop("/eos-box/stats/loop");
+		loop.add((int32_t)profileLoops.count).add((int32_t)profileLoops.low);
+		loop.add((int32_t)profileAverage(profileLoops)).add((int32_t)profileLoops.high);
+		boxReply(loop);
+		char address[32];
+		for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+			ProfileStats &stats = profileStats[i];
+			if (!stats.count) continue;
+			strcpy(address, "/eos-box/stats/");
+			strcat(address, profileNames[i]);
+			OSCMessage stage(address);
+			stage.add((int32_t)stats.count).add((int32_t)stats.low);
+			stage.add((int32_t)profileAverage(stats)).add((int32_t)stats.high);
+			boxReply(stage);
+			}
+		OSCMessage histogram("/eos-box/stats/histogram");
+		for (uint8_t i = 0; i < EOS_PROFILE_BINS; i++) histogram.add((int32_t)profileBins[i]);
+		boxReply(histogram);
+		return true;
+		}
+#endif
+#if EOS_LATENCY
+	if (isAddress(packet, size, "/eos-box/latency/reset")) {
+		latencyReset();
+		return true;
+		}
+	if (isAddress(packet, size, "/eos-box/latency")) {
+		// max in us and the histogram of each control class which was used, then the round-trip time
+		char address[32];
+		for (uint8_t i = 0; i < LATENCY_CLASSES; i++) {
+			if (!latencyUsed(i)) continue;
+			strcpy(address, "/eos-box/latency/");
+			strcat(address, latencyNames[i]);
+			OSCMessage type(address);
+			type.add((int32_t)latencyHigh[i]);
+			for (uint8_t j = 0; j < EOS_LATENCY_BINS; j++) type.add((int32_t)latencyBins[i][j]);
+			boxReply(type);
+			}
+		OSCMessage rtt("/eos-box/latency/rtt");
+		rtt.add((int32_t)rttMin()).add((int32_t)rttAvg()).add((int32_t)rttMax());
+		boxReply(rtt);
+		return true;
+		}
+#endif
+	return false;
+	}
+
+void EOS::boxReply(OSCMessage& msg) {
+	if (interface == EOSUDP) {
+		// to the sender of the query, e.g. a dashboard
+		udp->beginPacket(udp->remoteIP(), udp->remotePort());
+		EOSCount out(*udp);
+		msg.send(out);
+		udp->endPacket();
+		txPacketCount++;
+		txByteCount += out.size;
+		}
+	else sendPacket(msg, dests[0].ip, dests[0].port);
+	}
+
+uint8_t EOS::receive(void (*handler)(OSCMessage& msg)) {
+	// first fill the ring, the packets which don't fit stay in the buffer of the interface
+	if (interface == EOSUDP) rxPacketUDP();
+	if (interface == EOSUSB) rxPacketSLIP();
+	if (interface == EOSTCP) rxPacketTCP();
+	if (rxCount > rxHigh) rxHigh = rxCount;
+	uint8_t handled = 0;
+	if (transportCount) {
+		// with FAILOVER only the messages of the used transport are handled, the others are only watched
+		uint8_t active = transportPolicy == MIRROR ? EOS_ANY : transport();
+		for (uint8_t i = 0; i < transportCount; i++) {
+			handled += transports[i]->receive(active == EOS_ANY || active == i + 1 ? handler : NULL);
+			}
+		if (active != EOS_ANY && active != 0) handler = NULL;
+		}
+	while (rxCount) {
+		uint8_t *packet = rxRing[rxHead];
+		uint16_t size = rxSize[rxHead];
+		uint8_t from = rxFrom[rxHead];
+		rxHead = (rxHead + 1) % EOS_RX_SLOTS;
+		rxCount--;
+		if (from == 0 && discovery == DISCOVERY_SEARCH) continue; // not from a console we know
+		Destination &dest = dests[from];
+		dest.rxTime = clockMillis();
+		dest.dead = false;
+		if (size >= 7 && memcmp(packet, "ETCOSC?", 7) == 0) {
+			handshake();
+			continue;
+			}
+		if (!dest.connected) {
+			dest.connected = true;
+			if (dest.wasLost) runInit(1 << from); // the console may have been restarted
+			dest.wasLost = false;
+			if (from == 0 && discovery == DISCOVERY_CACHED) discovery = DISCOVERY_OFF; // the cache was right
+			replayQueue(); // edges from the discovery
+			}
+		Profile profile(PROFILE_PARSE);
+		OSCMessage msg;
+		msg.fill(packet, size);
+		// the other consoles send the same, they are only watched
+		if (msg.hasError() || pingEcho(msg, dest) || !handler || from != active()) continue;
+		handler(msg);
+		handled++;
+		}
+	return handled;
+	}
+
+void EOS::handshake() {
+	// USB only, EOS asks for the box and the box must answer before EOS sends
+	if (interface == EOSUSB) {
+		serialSLIP.beginPacket();
+		serialSLIP.write((const uint8_t*)"OK", 2);
+		serialSLIP.endPacket();
+		}
+	reinit();
+	dests[0].connected = true;
+	dests[0].wasLost = false;
+	}
+
+uint8_t EOS::rxHighWater() {
+	return rxHigh;
+	}
+
+uint16_t EOS::rxDropped() {
+	return rxDrops;
+	}
+
+void EOS::capture(bool on) {
+#if EOS_CAPTURE
+	if (on && !captureRing) captureRing = new EOSCapture;
+	captureOn = on;
+#endif
+	}
+
+bool EOS::capturing() {
+	return captureOn;
+	}
+
+uint32_t EOS::captureSize() {
+#if EOS_CAPTURE
+	if (captureRing) return captureRing->fill;
+#endif
+	return 0;
+	}
+
+uint16_t EOS::captureDropped() {
+#if EOS_CAPTURE
+	if (captureRing) return captureRing->drops;
+#endif
+	return 0;
+	}
+
+void EOS::captureClear() {
+#if EOS_CAPTURE
+	if (!captureRing) return;
+	captureRing->head = captureRing->fill = 0;
+	captureRing->drops = 0;
+#endif
+	}
+
+void EOS::captureDump(Print &out) {
+	out.write((const uint8_t*)"eOS\x01", 4); // magic and version of the file
+#if EOS_CAPTURE
+	if (captureRing) captureRing->dump(out, 0, captureRing->fill);
+#endif
+	}
+
+void EOS::captureDump(UDP &udp, IPAddress ip, uint16_t port) {
+#if EOS_CAPTURE
+	if (!captureRing) return;
+	uint32_t at = 0;
+	while (at < captureRing->fill) {
+		// whole records up to EOS_CAPTURE_CHUNK, a larger one gets its own datagram
+		uint32_t size = captureRing->recordSize(at);
+		while (at + size < captureRing->fill) {
+			uint32_t next = captureRing->recordSize(at + size);
+			if (size + next > EOS_CAPTURE_CHUNK) break;
+			size += next;
+			}
+		udp.beginPacket(ip, port);
+		captureRing->dump(udp, at, size);
+		udp.endPacket();
+		at += size;
+		}
+#endif
+	}
+
+void EOS::rxCommit(uint16_t size, uint8_t from) {
+	uint8_t slot = (rxHead + rxCount) % EOS_RX_SLOTS;
+	rxPacketCount++;
+	rxByteCount += size;
+#if EOS_CAPTURE
+	if (captureOn) captureRing->record(from, rxRing[slot], size);
+#endif
+	if (boxQuery(rxRing[slot], size)) return;
+	rxSize[slot] = size;
+	rxFrom[slot] = from;
+	rxCount++;
+	}
+
+void EOS::rxPacketUDP() {
+	Profile profile(PROFILE_RECEIVE);
+	int size;
+	// when the ring is full the rest stays in the buffer of the interface for the next loop
+	while (rxCount < EOS_RX_SLOTS && (size = udp->parsePacket()) > 0) {
+		if (size > EOS_RX_SLOT_SIZE) {
+			udp->flush(); // throw it away
+			rxDrops++;
+			continue;
+			}
+		// unknown senders count as the first console
+		uint8_t from = 0;
+		for (uint8_t i = 1; i < destCount; i++) {
+			if (udp->remoteIP() == dests[i].ip) from = i;
+			}
+		uint8_t *slot = rxRing[(rxHead + rxCount) % EOS_RX_SLOTS];
+		int got = udp->read(slot, size);
+		if (got <= 0) continue;
+		if (discovery == DISCOVERY_SEARCH) probeReply(slot, got);
+		rxCommit(got, from);
+		}
+	}
+
+void EOS::rxPacketSLIP() {
+	Profile profile(PROFILE_RECEIVE);
+	while (true) {
+		while (serialSLIP.available()) rxStore(serialSLIP.read());
+		if (!serialSLIP.endofPacket()) return; // packet not complete yet
+		rxFrame();
+		}
+	}
+
+void EOS::rxPacketTCP() {
+	Profile profile(PROFILE_RECEIVE);
+	if (!tcpUp) return;
+	uint8_t chunk[32];
+	int size;
+	// the packets are decoded while they come in, a packet can be split over reads
+	while (rxCount < EOS_RX_SLOTS && (size = client->available()) > 0) {
+		int got = client->read(chunk, size < (int)sizeof(chunk) ? size : sizeof(chunk));
+		if (got <= 0) return;
+		for (int i = 0; i < got; i++) {
+			uint8_t c = chunk[i];
+			if (tcp->framing == TCP_SLIP) {
+				if (c == eot) rxFrame();
+				else if (c == slipesc) tcp->escape = true;
+				else {
+					if (tcp->escape) c = c == slipescend ? eot : slipesc;
+					tcp->escape = false;
+					rxStore(c);
+					}
+				continue;
+				}
+			if (tcp->header < 4) {
+				tcp->length = tcp->header ? (tcp->length << 8) | c : c;
+				if (++tcp->header == 4 && tcp->length == 0) tcp->header = 0; // empty packet
+				continue;
+				}
+			rxStore(c);
+			if (--tcp->length == 0) {
+				rxFrame();
+				tcp->header = 0;
+				}
+			}
+		}
+	}
+
+void EOS::rxStore(uint8_t c) {
+	if (rxCount < EOS_RX_SLOTS && rxFill < EOS_RX_SLOT_SIZE) {
+		rxRing[(rxHead + rxCount) % EOS_RX_SLOTS][rxFill++] = c;
+		}
+	else rxOverflow = true;
+	}
+
+void EOS::rxFrame() {
+	if (rxOverflow) rxDrops++;
+	else if (rxFill) rxCommit(rxFill, 0);
+	rxFill = 0;
+	rxOverflow = false;
+	}
+
+// weak, the library links also without a global eos, e.g. with two consoles
+extern EOS eos __attribute__((weak));
+
+/**
+ * @brief send a message of a control to its EOS object or to the global eos
+ * 
+ */
+static void sendTo(EOS *target, OSCMessage& msg, uint8_t transport) {
+	if (!target) target = &eos;
+	if (target) target->sendOSC(msg, transport);
+	latencyEnd();
+	}
+
+/**
+ * @brief send the message of a button edge, it is kept while the link is down
+ * 
+ */
+static void sendEdge(EOS *target, const LinkEdge &edge, uint8_t transport) {
+	OSCMessage msg;
+	edge.message(edge.control, edge.value, msg);
+	sendingEdge = &edge;
+	sendTo(target, msg, transport);
+	sendingEdge = NULL;
+	}
+
+/**
+ * @brief the EOS object of the helpers without a target, while an init runs its EOS object, e.g. a transport,
+ * else the global eos
+ * 
+ */
+static EOS *helperTarget() {
+	return initTarget ? initTarget : &eos;
+	}
 
 void filter(String pattern) {
+	EOS *target = helperTarget();
+	if (target) filter(*target, pattern);
+	}
+
+void filter(EOS &target, String pattern) {
 	OSCMessage filter("/eos/filter/add");
 	filter.add(pattern.c_str());
-	eos.sendOSC(filter);
+	target.sendOSC(filter);
 	}
 
 void subscribe(String parameter) {
+	EOS *target = helperTarget();
+	if (target) subscribe(*target, parameter);
+	}
+
+void subscribe(EOS &target, String parameter) {
 	String subPattern = "/eos/subscribe/param/" + parameter;
 	OSCMessage sub(subPattern.c_str());
 	sub.add(SUBSCRIBE);
-	eos.sendOSC(sub);
+	target.sendOSC(sub);
 	}
 
 void unSubscribe(String parameter) {
+	EOS *target = helperTarget();
+	if (target) unSubscribe(*target, parameter);
+	}
+
+void unSubscribe(EOS &target, String parameter) {
 	String subPattern = "/eos/subscribe/param/" + parameter;
 	OSCMessage sub(subPattern.c_str());
 	sub.add(UNSUBSCRIBE);
-	eos.sendOSC(sub);
+	target.sendOSC(sub);
 	}
 
 void ping() {
+	EOS *target = helperTarget();
+	if (target) ping(*target);
+	}
+
+void ping(EOS &target) {
 	OSCMessage ping("/eos/ping");
-	eos.sendOSC(ping);
+	target.sendOSC(ping);
 	}
 
 void ping(String message) {
+	EOS *target = helperTarget();
+	if (target) ping(*target, message);
+	}
+
+void ping(EOS &target, String message) {
 	OSCMessage ping("/eos/ping");
 	ping.add(message.c_str());
-	eos.sendOSC(ping);
+	target.sendOSC(ping);
 	}
 
 void command(String cmd) {
+	EOS *target = helperTarget();
+	if (target) command(*target, cmd);
+	}
+
+void command(EOS &target, String cmd) {
 	OSCMessage cmdPattern("/eos/cmd");
 	cmdPattern.add(cmd.c_str());
-	eos.sendOSC(cmdPattern);
+	target.sendOSC(cmdPattern);
 	}
 
 void newCommand(String newCmd) {
+	EOS *target = helperTarget();
+	if (target) newCommand(*target, newCmd);
+	}
+
+void newCommand(EOS &target, String newCmd) {
 	OSCMessage newCmdPattern("/eos/newcmd");
 	newCmdPattern.add(newCmd.c_str());
-	eos.sendOSC(newCmdPattern);
+	target.sendOSC(newCmdPattern);
 	}
 
 void user(int16_t userID) {
+	EOS *target = helperTarget();
+	if (target) user(*target, userID);
+	}
+
+void user(EOS &target, int16_t userID) {
 	OSCMessage userPattern("/eos/user");
 	userPattern.add(userID);
-	eos.sendOSC(userPattern);
+	target.sendOSC(userPattern);
+	}
+
+void profileReport(Print &out) {
+#if EOS_PROFILE
+	out.println("stage\tcount\tmin\tavg\tmax us");
+	out.print("loop\t");
+	out.print((unsigned long)profileLoops.count);
+	out.print('\t');
+	out.print((unsigned long)profileLoops.low);
+	out.print('\t');
+	out.print((unsigned long)profileAverage(profileLoops));
+	out.print('\t');
+	out.println((unsigned long)profileLoops.high);
+	for (uint8_t i = 0; i < PROFILE_STAGES; i++) {
+		ProfileStats &stats = profileStats[i];
+		if (!stats.count) continue;
+		out.print(profileNames[i]);
+		out.print('\t');
+		out.print((unsigned long)stats.count);
+		out.print('\t');
+		out.print((unsigned long)stats.low);
+		out.print('\t');
+		out.print((unsigned long)profileAverage(stats));
+		out.print('\t');
+		out.println((unsigned long)stats.high);
+		}
+	uint32_t limit = 64;
+	for (uint8_t i = 0; i < EOS_PROFILE_BINS; i++, limit <<= 1) {
+		out.print(i < EOS_PROFILE_BINS - 1 ? "loop < " : "loop >= ");
+		out.print((unsigned long)(i < EOS_PROFILE_BINS - 1 ? limit : limit / 2));
+		out.print("us\t");
+		out.println((unsigned long)profileBins[i]);
+		}
+#endif
+	}
+
+void profileReset() {
+#if EOS_PROFILE
+	memset(profileStats, 0, sizeof(profileStats));
+	memset(&profileLoops, 0, sizeof(profileLoops));
+	memset(profileBins, 0, sizeof(profileBins));
+	profileStarted = false;
+#endif
+	}
+
+void latencyReport(Print &out) {
+#if EOS_LATENCY
+	out.print("latency us\tmax");
+	uint32_t limit = 16;
+	for (uint8_t i = 0; i < EOS_LATENCY_BINS; i++, limit <<= 1) {
+		out.print(i < EOS_LATENCY_BINS - 1 ? "\t<" : "\t>=");
+		out.print((unsigned long)(i < EOS_LATENCY_BINS - 1 ? limit : limit / 2));
+		}
+	out.println();
+	for (uint8_t i = 0; i < LATENCY_CLASSES; i++) {
+		if (!latencyUsed(i)) continue;
+		out.print(latencyNames[i]);
+		out.print('\t');
+		out.print((unsigned long)latencyHigh[i]);
+		for (uint8_t j = 0; j < EOS_LATENCY_BINS; j++) {
+			out.print('\t');
+			out.print(latencyBins[i][j]);
+			}
+		out.println();
+		}
+#endif
+	}
+
+void latencyReset() {
+#if EOS_LATENCY
+	memset(latencyBins, 0, sizeof(latencyBins));
+	memset(latencyHigh, 0, sizeof(latencyHigh));
+#endif
+	}
+
+uint32_t freeRam() {
+#if defined(__AVR__)
+	char top;
+	uint32_t total = &top - heapEnd();
+	for (struct __freelist *block = __flp; block; block = block->nx) total += block->sz + 2;
+	return total;
+#elif defined(ESP8266) || defined(ESP32)
+	return ESP.getFreeHeap();
+#elif defined(RAM_PAINT)
+	char top;
+	return &top - heapEnd(); // without the free blocks of the heap
+#else
+	return 0;
+#endif
+	}
+
+uint8_t heapFragmentation() {
+#if defined(__AVR__)
+	char top;
+	uint32_t largest = &top - heapEnd();
+	uint32_t total = largest;
+	for (struct __freelist *block = __flp; block; block = block->nx) {
+		total += block->sz + 2;
+		if (block->sz > largest) largest = block->sz;
+		}
+	return total ? 100 - largest * 100 / total : 0;
+#elif defined(ESP8266)
+	return ESP.getHeapFragmentation();
+#elif defined(ESP32)
+	uint32_t total = ESP.getFreeHeap();
+	return total ? 100 - ESP.getMaxAllocHeap() * 100 / total : 0;
+#else
+	return 0;
+#endif
+	}
+
+uint32_t ramLowWater() {
+#if defined(RAM_PAINT)
+	// the longest run of paint is RAM which was never used
+	if (!ramPainted) return 0;
+	char top;
+	uint32_t run = 0, longest = 0;
+	for (volatile char *p = ramPainted; p < &top; p++) {
+		if (*p != (char)RAM_PAINT) run = 0;
+		else if (++run > longest) longest = run;
+		}
+	return longest;
+#elif defined(ESP32)
+	return ESP.getMinFreeHeap();
+#else
+	return ramLow;
+#endif
+	}
+
+/**
+ * @brief print one line of the RAM report
+ * 
+ */
+static void ramLine(Print &out, const char *name, uint32_t bytes) {
+	out.print(name);
+	out.print(' ');
+	out.println(bytes);
+	}
+
+void ramReport(Print &out) {
+	out.println(F("RAM bytes"));
+	ramLine(out, "EOS", sizeof(EOS)); // the capture ring is on the heap
+	ramLine(out, "  rx ring", EOS_RX_SLOTS * EOS_RX_SLOT_SIZE);
+	ramLine(out, "  link queue", EOS_LINK_QUEUE * sizeof(LinkEdge));
+	ramLine(out, "Encoder", EOS_RAM_ENCODER);
+	ramLine(out, "Wheel", EOS_RAM_WHEEL);
+	ramLine(out, "Key", EOS_RAM_KEY);
+	ramLine(out, "Submaster", EOS_RAM_SUBMASTER);
+	ramLine(out, "Fader", EOS_RAM_FADER);
+	ramLine(out, "Macro", EOS_RAM_MACRO);
+	ramLine(out, "OscButton", EOS_RAM_OSCBUTTON);
+	out.println(F("heap"));
+	ramLine(out, "  tx buffer", EOS_TX_SIZE); // with a second console
+	ramLine(out, "  tcp buffer", EOS_TCP_TX_SIZE); // with TCP
+	ramLine(out, "  capture", EOS_CAPTURE); // after capture()
+	ramLine(out, "free", freeRam());
+	ramLine(out, "fragmentation %", heapFragmentation());
+	ramLine(out, "low water", ramLowWater());
+	}
+
+static uint32_t (*clockMs)(); // NULL is the clock of the board
+static uint32_t (*clockUs)();
+static uint32_t clockMsLast; // ms clock of the last step of clockMicros()
+static uint32_t clockUsCount; // us counted in steps of the ms clock, wraps like micros()
+static uint32_t clockUsStep; // micros() of the board at the last step
+
+void clockSource(uint32_t (*ms)(), uint32_t (*us)()) {
+	clockMs = ms;
+	clockUs = us;
+	clockMsLast = ms ? ms() : 0;
+	clockUsCount = 0;
+	clockUsStep = micros();
+	}
+
+uint32_t clockMillis() {
+	return clockMs ? clockMs() : millis();
+	}
+
+/**
+ * @brief without a us clock the us are counted from the steps of the ms clock, so they wrap after 2^32 us
+ * like micros() and a difference stays right, between two steps the us of the board fill in up to 999
+ * 
+ */
+uint32_t clockMicros() {
+	if (clockUs) return clockUs();
+	if (!clockMs) return micros();
+	uint32_t ms = clockMs();
+	if (ms != clockMsLast) {
+		clockUsCount += (ms - clockMsLast) * 1000;
+		clockMsLast = ms;
+		clockUsStep = micros();
+		}
+	uint32_t us = micros() - clockUsStep;
+	return clockUsCount + (us < 1000 ? us : 999);
 	}
 
 Key::Key(uint8_t pin, String keyName) {
@@ -104,21 +1783,30 @@ Key::Key(uint8_t pin, String keyName) {
 	keyPattern = "/eos/key/" + keyName;	
 	}
 
+void Key::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Key::bind(EOS &target) {
+	this->target = &target;
+	}
+
 void Key::update() {
+	Profile profile(PROFILE_KEY);
 	if((digitalRead(pin)) != last) {
-		OSCMessage keyUpdate(keyPattern.c_str());
-		if (last == LOW) {
-			last = HIGH;
-			keyUpdate.add(EDGE_UP);
-			}
-		else {
-			last = LOW;
-			keyUpdate.add(EDGE_DOWN);
-			}
-		eos.sendOSC(keyUpdate);
+		latencyEdge(LATENCY_KEY);
+		last = last == LOW ? HIGH : LOW;
+		uint8_t value = last == LOW ? EDGE_DOWN : EDGE_UP;
+		LinkEdge edge = {edgeMessage, this, value};
+		sendEdge(target, edge, transportIndex);
 		}
 	}
 
+void Key::edgeMessage(const void *key, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress(((const Key*)key)->keyPattern.c_str());
+	msg.add((int32_t)value);
+	}
+
 uint8_t shiftPin;
 
 void shiftButton(uint8_t pin) {
@@ -152,10 +1840,20 @@ String Encoder::parameter() {
 	return param;
 	}
 
+void Encoder::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Encoder::bind(EOS &target) {
+	this->target = &target;
+	}
+
 void Encoder::update() {
+	Profile profile(PROFILE_ENCODER);
 	encoderMotion = 0;
 	pinACurrent = digitalRead(pinA);	
 	if ((pinALast) && (!pinACurrent)) {
+		latencyEdge(LATENCY_ENCODER);
 		if (digitalRead(pinB)) {
 			encoderMotion = - 1;
 			}
@@ -186,27 +1884,27 @@ void Encoder::update() {
 		wheelMsg += '/' + param;
 		OSCMessage wheelUpdate(wheelMsg.c_str());
 		wheelUpdate.add(encoderMotion);
-		eos.sendOSC(wheelUpdate);
+		sendTo(target, wheelUpdate, transportIndex);
 		}
 	
 	if (buttonPin) {
 		if (buttonMode == HOME) {
 			if((digitalRead(buttonPin)) != buttonPinLast) {
-				OSCMessage buttonUpdate(("/eos/param/" + param + "/home").c_str());
-				if(buttonPinLast == LOW) {
-					buttonPinLast = HIGH;
-					buttonUpdate.add(EDGE_UP);
-					}
-				else {
-					buttonPinLast = LOW;
-					buttonUpdate.add(EDGE_DOWN);
-					}
-				eos.sendOSC(buttonUpdate);
+				latencyEdge(LATENCY_ENCODER);
+				buttonPinLast = buttonPinLast == LOW ? HIGH : LOW;
+				uint8_t value = buttonPinLast == LOW ? EDGE_DOWN : EDGE_UP;
+				LinkEdge edge = {homeMessage, this, value};
+				sendEdge(target, edge, transportIndex);
 				}	
 			}
 		}
 	}
 
+void Encoder::homeMessage(const void *encoder, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress(("/eos/param/" + ((const Encoder*)encoder)->param + "/home").c_str());
+	msg.add((int32_t)value);
+	}
+
 Wheel::Wheel(uint8_t pinA, uint8_t pinB, uint8_t direction) {
 	this->pinA = pinA;
 	this->pinB = pinB;
@@ -231,10 +1929,20 @@ uint8_t Wheel::index() {
 	return idx;
 	}
 
+void Wheel::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Wheel::bind(EOS &target) {
+	this->target = &target;
+	}
+
 void Wheel::update() {
+	Profile profile(PROFILE_WHEEL);
 	encoderMotion = 0;
 	pinACurrent = digitalRead(pinA);	
 	if ((pinALast) && (!pinACurrent)) {
+		latencyEdge(LATENCY_WHEEL);
 		if (digitalRead(pinB)) {
 			encoderMotion = - 1;
 			}
@@ -266,7 +1974,7 @@ void Wheel::update() {
 		wheelMsg += '/' + String(idx);
 		OSCMessage wheelUpdate(wheelMsg.c_str());
 		wheelUpdate.add(encoderMotion);
-		eos.sendOSC(wheelUpdate);
+		sendTo(target, wheelUpdate, transportIndex);
 		}
 	}
 
@@ -277,42 +1985,57 @@ Submaster::Submaster(uint8_t analogPin, uint8_t firePin, uint8_t sub) {
 	if (firePin) pinMode(firePin, INPUT_PULLUP);
 	fireLast = digitalRead(firePin);
 	subPattern = "/eos/sub/" + String(sub);
-	updateTime = millis();
+	updateTime = clockMillis();
+	}
+
+void Submaster::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Submaster::bind(EOS &target) {
+	this->target = &target;
 	}
 
 void Submaster::update() {
-	if ((updateTime + FADER_UPDATE_RATE_MS) < millis()) {
+	Profile profile(PROFILE_SUBMASTER);
+	if ((clockMillis() - updateTime) > FADER_UPDATE_RATE_MS) {
 		int16_t raw = analogRead(analogPin) >> 2; // reduce to 8 bit
 		int16_t current = THRESHOLD;
 		int16_t delta = raw - current;
 		if (delta <= -THRESHOLD) current = raw + THRESHOLD;
 		if (delta >= THRESHOLD) current = raw - THRESHOLD;
 		if (current != analogLast) {
+			latencyEdge(LATENCY_SUBMASTER);
 			float value = ((current - THRESHOLD) * 1.0 / (255 - 2 * THRESHOLD)) / 1.0; // normalize to values between 0.0 and 1.0
 			analogLast = current;
 			OSCMessage faderUpdate(subPattern.c_str());
 			faderUpdate.add(value);
-			eos.sendOSC(faderUpdate);
+			sendTo(target, faderUpdate, transportIndex);
 			}
-		updateTime = millis();
+		updateTime = clockMillis();
 		}
 	if (firePin) {
 		if((digitalRead(firePin)) != fireLast) {
-			OSCMessage fireUpdate((subPattern + "/fire").c_str());
-			if(fireLast == LOW) {
-				fireLast = HIGH;
-				fireUpdate.add(EDGE_UP);
-				}
-			else {
-				fireLast = LOW;
-				fireUpdate.add(EDGE_DOWN);
-				}
-			eos.sendOSC(fireUpdate);
+			latencyEdge(LATENCY_SUBMASTER);
+			fireLast = fireLast == LOW ? HIGH : LOW;
+			uint8_t value = fireLast == LOW ? EDGE_DOWN : EDGE_UP;
+			LinkEdge edge = {fireMessage, this, value};
+			sendEdge(target, edge, transportIndex);
 			}
 		}
 	}
 
+void Submaster::fireMessage(const void *sub, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress((((const Submaster*)sub)->subPattern + "/fire").c_str());
+	msg.add((int32_t)value);
+	}
+
 void initFaders(uint8_t page, uint8_t faders, uint8_t bank) {
+	EOS *target = helperTarget();
+	if (target) initFaders(*target, page, faders, bank);
+	}
+
+void initFaders(EOS &target, uint8_t page, uint8_t faders, uint8_t bank) {
 	String faderInit = "/eos/fader/";
 	faderInit += bank;
 	faderInit += "/config/";
@@ -320,7 +2043,7 @@ void initFaders(uint8_t page, uint8_t faders, uint8_t bank) {
 	faderInit += '/';
 	faderInit += faders;
 	OSCMessage faderBank(faderInit.c_str());
-	eos.sendOSC(faderBank);
+	target.sendOSC(faderBank);
 	}
 
 Fader::Fader(uint8_t analogPin, uint8_t firePin, uint8_t stopPin, uint8_t fader, uint8_t bank) {
@@ -335,57 +2058,67 @@ Fader::Fader(uint8_t analogPin, uint8_t firePin, uint8_t stopPin, uint8_t fader,
 	fireLast = digitalRead(firePin);
 	stopLast = digitalRead(stopPin);
 	faderPattern = "/eos/fader/" + String(bank) + '/' + String(fader);
-	updateTime = millis();
+	updateTime = clockMillis();
+	}
+
+void Fader::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Fader::bind(EOS &target) {
+	this->target = &target;
 	}
 
 void Fader::update() {
-	if ((updateTime + FADER_UPDATE_RATE_MS) < millis()) {
+	Profile profile(PROFILE_FADER);
+	if ((clockMillis() - updateTime) > FADER_UPDATE_RATE_MS) {
 		int16_t raw = analogRead(analogPin) >> 2; // reduce to 8 bit
 		int16_t current = THRESHOLD;
 		int16_t delta = raw - current;
 		if (delta <= -THRESHOLD) current = raw + THRESHOLD;
 		if (delta >= THRESHOLD) current = raw - THRESHOLD;
 		if (current != analogLast) {
+			latencyEdge(LATENCY_FADER);
 			float value = ((current - THRESHOLD) * 1.0 / (255 - 2 * THRESHOLD)) / 1.0; // normalize to values between 0.0 and 1.0
 			analogLast = current;
 			OSCMessage faderUpdate(faderPattern.c_str());
 			faderUpdate.add(value);
-			eos.sendOSC(faderUpdate);
+			sendTo(target, faderUpdate, transportIndex);
 			}
-		updateTime = millis();
+		updateTime = clockMillis();
 		}	
 
 	if (firePin) {
 		if((digitalRead(firePin)) != fireLast) {
-			OSCMessage fireUpdate((faderPattern + "/fire").c_str());
-			if(fireLast == LOW) {
-				fireLast = HIGH;
-				fireUpdate.add(EDGE_UP);
-				}
-			else {
-				fireLast = LOW;
-				fireUpdate.add(EDGE_DOWN);
-				}
-			eos.sendOSC(fireUpdate);
+			latencyEdge(LATENCY_FADER);
+			fireLast = fireLast == LOW ? HIGH : LOW;
+			uint8_t value = fireLast == LOW ? EDGE_DOWN : EDGE_UP;
+			LinkEdge edge = {fireMessage, this, value};
+			sendEdge(target, edge, transportIndex);
 			}
 		}
 
 	if (stopPin) {
 		if((digitalRead(stopPin)) != stopLast) {
-			OSCMessage stopUpdate((faderPattern + "/stop").c_str());
-			if(stopLast == LOW) {
-				stopLast = HIGH;
-				stopUpdate.add(EDGE_UP);
-				}
-			else {
-				stopLast = LOW;
-				stopUpdate.add(EDGE_DOWN);
-				}
-			eos.sendOSC(stopUpdate);
+			latencyEdge(LATENCY_FADER);
+			stopLast = stopLast == LOW ? HIGH : LOW;
+			uint8_t value = stopLast == LOW ? EDGE_DOWN : EDGE_UP;
+			LinkEdge edge = {stopMessage, this, value};
+			sendEdge(target, edge, transportIndex);
 			}
 		}
 	}
 
+void Fader::fireMessage(const void *fader, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress((((const Fader*)fader)->faderPattern + "/fire").c_str());
+	msg.add((int32_t)value);
+	}
+
+void Fader::stopMessage(const void *fader, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress((((const Fader*)fader)->faderPattern + "/stop").c_str());
+	msg.add((int32_t)value);
+	}
+
 void Fader::faderBank(uint8_t bank) {
 	this->bank = bank;
 	}
@@ -409,21 +2142,30 @@ Macro::Macro(uint8_t pin, uint16_t macro) {
 	firePattern = "/eos/macro/" + String(macro) + "/fire";
 	}
 
+void Macro::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void Macro::bind(EOS &target) {
+	this->target = &target;
+	}
+
 void Macro::update() {
+	Profile profile(PROFILE_MACRO);
 	if ((digitalRead(pin)) != last) {
-		OSCMessage fireUpdate(firePattern.c_str());
-		if (last == LOW) {
-			last = HIGH;
-			fireUpdate.add(EDGE_UP);
-			}
-		else {
-			last = LOW;
-			fireUpdate.add(EDGE_DOWN);
-			}
-		eos.sendOSC(fireUpdate);
+		latencyEdge(LATENCY_MACRO);
+		last = last == LOW ? HIGH : LOW;
+		uint8_t value = last == LOW ? EDGE_DOWN : EDGE_UP;
+		LinkEdge edge = {fireMessage, this, value};
+		sendEdge(target, edge, transportIndex);
 		} 
 	}
 
+void Macro::fireMessage(const void *macro, uint8_t value, OSCMessage &msg) {
+	msg.empty().setAddress(((const Macro*)macro)->firePattern.c_str());
+	msg.add((int32_t)value);
+	}
+
 OscButton::OscButton(uint8_t pin, String pattern, int32_t integer32) {
 	this->pin = pin;
 	this->pattern = pattern;
@@ -502,18 +2244,40 @@ OscButton::OscButton(uint8_t pin, String pattern, IPAddress ip, uint16_t port) {
 	typ = NONE;
 	}
 
+void OscButton::transport(uint8_t index) {
+	transportIndex = index;
+	}
+
+void OscButton::bind(EOS &target) {
+	this->target = &target;
+	}
+
 void OscButton::update() {
+	Profile profile(PROFILE_OSCBUTTON);
 	if ((digitalRead(pin)) != last) {
 		if (last == LOW) {
 			last = HIGH;
 			}
 		else {
 			last = LOW;
-			OSCMessage osc(pattern.c_str());
-			if (typ == INT32) osc.add(integer32);
-			if (typ == FLOAT32) osc.add(float32);
-			if (typ == STRING) osc.add(message.c_str());
-			eos.sendOSC(osc, ip, port);
+			latencyEdge(LATENCY_OSCBUTTON);
+			LinkEdge edge = {pressMessage, this, EDGE_DOWN};
+			if (port) {
+				OSCMessage osc;
+				pressMessage(this, EDGE_DOWN, osc);
+				EOS *out = target ? target : &eos;
+				if (out) out->sendOSC(osc, ip, port);
+				latencyEnd();
+				}
+			else sendEdge(target, edge, transportIndex);
 			}
 		} 
+	}
+
+void OscButton::pressMessage(const void *button, uint8_t value, OSCMessage &msg) {
+	const OscButton *b = (const OscButton*)button;
+	msg.empty().setAddress(b->pattern.c_str());
+	if (b->typ == INT32) msg.add(b->integer32);
+	if (b->typ == FLOAT32) msg.add(b->float32);
+	if (b->typ == STRING) msg.add(b->message.c_str());
 	}
\ No newline at end of file
@@ -60,29 +60,18 @@ THE SOFTWARE.
 
 #define SIG_DIGITS		3 // Number of significant digits displayed
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "box1x_hello";
 const String PARAMETER_QUERY = "/eos/out/param/";
 
 // See displayScreen() below - limited to 10 chars (after 6 prefix chars)
 const String VERSION_STRING = "2.0.0.0";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
 const String ENCODER_1_PARAMETER = "Pan";
 const String ENCODER_2_PARAMETER = "Tilt";
 
 // Global variables
 bool updateDisplay = false;
 bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
 
 struct Parameter {
 	String name;
@@ -91,6 +80,7 @@ struct Parameter {
 	} enc1, enc2;
 
 // Hardware constructors
+EOS eos;
 LiquidCrystal lcd(LCD_RS, LCD_ENABLE, LCD_D4, LCD_D5, LCD_D6, LCD_D7); // rs, enable, d4, d5, d6, d7
 
 // 
@@ -102,12 +92,11 @@ Encoder encoder2(ENC_2_A, ENC_2_B, FORWARD);
 // Local functions
 
 /**
- * @brief Init the console, gives back a handshake reply
- * and send the filters and subscribtions.
+ * @brief Init the console, send the filters and subscribtions,
+ * eOS sends them as one bundle after the handshake.
  *
  */
 void initEOS() {
-	SLIPSerial.print(HANDSHAKE_REPLY);
 	filter("/eos/out/param/*");
 	filter("/eos/out/ping");
 	subscribe(ENCODER_1_PARAMETER);
@@ -124,41 +113,26 @@ void initEOS() {
  */
 void parseEnc1Update(OSCMessage& msg, int addressOffset) {
 	enc1.value = msg.getOSCData(0)->getFloat();
-	connectedToEos = true; // Update this here just in case we missed the handshake
 	updateDisplay = true; 
 	}
 
 void parseEnc2Update(OSCMessage& msg, int addressOffset) {
 	enc2.value = msg.getOSCData(0)->getFloat();
-	connectedToEos = true; // Update this here just in case we missed the handshake
 	updateDisplay = true;
 	}
 
 /**
  * @brief 
- * Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue a subscribe, otherwise we begin route the OSC
- * message to the appropriate function.
+ * Given an OSC message we route it to the appropriate function,
+ * the handshake is already handled by eOS.
  * 
  * @param msg - the OSC message of unknown importance
  *
  */
-void parseOSCMessage(String& msg) {
-	// Check to see if this is the handshake string
-	if (msg.indexOf(HANDSHAKE_QUERY) != -1) {
-		initEOS();
-		// Make our splash screen go away
-		connectedToEos = true;
-		updateDisplay = true;
-		}
-	else {
-		// Prepare the message for routing by filling an OSCMessage object with our message string
-		OSCMessage oscmsg;
-		oscmsg.fill((uint8_t*)msg.c_str(), (int)msg.length());
-		// Route parameter messages to the relevant update function
-		oscmsg.route((PARAMETER_QUERY + ENCODER_1_PARAMETER).c_str(), parseEnc1Update);
-		oscmsg.route((PARAMETER_QUERY + ENCODER_2_PARAMETER).c_str(), parseEnc2Update);
-		}
+void parseOSCMessage(OSCMessage& msg) {
+	// Route parameter messages to the relevant update function
+	msg.route((PARAMETER_QUERY + ENCODER_1_PARAMETER).c_str(), parseEnc1Update);
+	msg.route((PARAMETER_QUERY + ENCODER_2_PARAMETER).c_str(), parseEnc2Update);
 	}
 
 /**
@@ -214,7 +188,9 @@ void setup() {
 	lcd.begin(LCD_CHARS, LCD_LINES);
 	lcd.clear();
 
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS);
+	eos.reinit(); // for hotplug with Arduinos without native USB like UNO
 	shiftButton(SHIFT_BTN);
 	encoder1.parameter(ENCODER_1_PARAMETER);
 	encoder2.parameter(ENCODER_2_PARAMETER);
@@ -234,9 +210,6 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
 	// Check for hardware updates
 	next.update();
 	last.update();
@@ -244,36 +217,13 @@ void loop() {
 	encoder2.update();
 
 	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = SLIPSerial.available();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(SLIPSerial.read());
-		}
-	if (SLIPSerial.endofPacket()) {
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			updateDisplay = true;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;
-			}
+	// and update the display accordingly, the handshake, the pings
+	// and the timeout are handled by eOS
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		updateDisplay = true;
 		}
 	if (updateDisplay) displayStatus();
 	}
@@ -10,6 +10,13 @@
 #include "utility/util.h"
 
 int DhcpClass::beginWithDHCP(uint8_t *mac, unsigned long timeout, unsigned long responseTimeout)
+{
+    startDHCP(mac, timeout, responseTimeout);
+    _leasePending = DHCP_LEASE_NONE;
+    return request_DHCP_lease();
+}
+
+void DhcpClass::startDHCP(uint8_t *mac, unsigned long timeout, unsigned long responseTimeout)
 {
     _dhcpLeaseTime=0;
     _dhcpT1=0;
@@ -17,6 +24,7 @@ int DhcpClass::beginWithDHCP(uint8_t *mac, unsigned long timeout, unsigned long
     _lastCheck=0;
     _timeout = timeout;
     _responseTimeout = responseTimeout;
+    _requestRunning = false;
 
     // zero out _dhcpMacAddr
     memset(_dhcpMacAddr, 0, 6); 
@@ -24,7 +32,7 @@ int DhcpClass::beginWithDHCP(uint8_t *mac, unsigned long timeout, unsigned long
 
     memcpy((void*)_dhcpMacAddr, (void*)mac, 6);
     _dhcp_state = STATE_DHCP_START;
-    return request_DHCP_lease();
+    _leasePending = DHCP_LEASE_INITIAL;
 }
 
 void DhcpClass::reset_DHCP_lease(){
@@ -34,99 +42,113 @@ void DhcpClass::reset_DHCP_lease(){
 
 //return:0 on error, 1 if request is sent and response is received
 int DhcpClass::request_DHCP_lease(){
+    int result;
+    while ((result = step_DHCP_lease()) == DHCP_STEP_BUSY) {
+        // don't poll the chip in a tight loop, delay() also runs yield()
+        // for the watchdog of ESP boards and moves the clock of the host build
+        delay(1);
+    }
+    return result == DHCP_STEP_LEASED ? 1 : 0;
+}
+
+// Advances the lease request by one step, never waits for the server.
+// Every call sends at most one message and reads at most one packet.
+uint8_t DhcpClass::step_DHCP_lease(){
     
     uint8_t messageType = 0;
-  
-    
-  
-    // Pick an initial transaction ID
-    _dhcpTransactionId = random(1UL, 2000UL);
-    _dhcpInitialTransactionId = _dhcpTransactionId;
+    uint8_t result = DHCP_STEP_BUSY;
+    unsigned long now = millis();
 
-    _dhcpUdpSocket.stop();
-    if (_dhcpUdpSocket.begin(DHCP_CLIENT_PORT) == 0)
+    if (!_requestRunning)
     {
-      // Couldn't get a socket
-      return 0;
+        // Pick an initial transaction ID
+        _dhcpTransactionId = random(1UL, 2000UL);
+        _dhcpInitialTransactionId = _dhcpTransactionId;
+
+        _dhcpUdpSocket.stop();
+        if (_dhcpUdpSocket.begin(DHCP_CLIENT_PORT) == 0)
+        {
+          // Couldn't get a socket
+          return DHCP_STEP_FAILED;
+        }
+
+        presend_DHCP();
+        _requestStart = now;
+        _requestRunning = true;
     }
-    
-    presend_DHCP();
-    
-    int result = 0;
-    
-    unsigned long startTime = millis();
-    
-    while(_dhcp_state != STATE_DHCP_LEASED)
+
+    if(_dhcp_state == STATE_DHCP_START)
     {
-        if(_dhcp_state == STATE_DHCP_START)
+        _dhcpTransactionId++;
+        send_DHCP_MESSAGE(DHCP_DISCOVER, ((now - _requestStart) / 1000));
+        _dhcp_state = STATE_DHCP_DISCOVER;
+        _responseStart = now;
+    }
+    else if(_dhcp_state == STATE_DHCP_REREQUEST){
+        _dhcpTransactionId++;
+        send_DHCP_MESSAGE(DHCP_REQUEST, ((now - _requestStart)/1000));
+        _dhcp_state = STATE_DHCP_REQUEST;
+        _responseStart = now;
+    }
+    else if(_dhcp_state == STATE_DHCP_DISCOVER)
+    {
+        uint32_t respId;
+        messageType = parseDHCPResponse(respId);
+        if(messageType == DHCP_OFFER)
         {
-            //Serial.println("DHCP_START");
-			_dhcpTransactionId++;
-            
-            send_DHCP_MESSAGE(DHCP_DISCOVER, ((millis() - startTime) / 1000));
-            _dhcp_state = STATE_DHCP_DISCOVER;
-        }
-        else if(_dhcp_state == STATE_DHCP_REREQUEST){
-            _dhcpTransactionId++;
-            send_DHCP_MESSAGE(DHCP_REQUEST, ((millis() - startTime)/1000));
+            // We'll use the transaction ID that the offer came with,
+            // rather than the one we were up to
+            _dhcpTransactionId = respId;
+            send_DHCP_MESSAGE(DHCP_REQUEST, ((now - _requestStart) / 1000));
             _dhcp_state = STATE_DHCP_REQUEST;
+            _responseStart = now;
         }
-        else if(_dhcp_state == STATE_DHCP_DISCOVER)
+    }
+    else if(_dhcp_state == STATE_DHCP_REQUEST)
+    {
+        uint32_t respId;
+        messageType = parseDHCPResponse(respId);
+        if(messageType == DHCP_ACK)
         {
-            uint32_t respId;
-			
-            messageType = parseDHCPResponse(_responseTimeout, respId);
-            if(messageType == DHCP_OFFER)
-            {
-                
-				// We'll use the transaction ID that the offer came with,
-                // rather than the one we were up to
-                _dhcpTransactionId = respId;
-                send_DHCP_MESSAGE(DHCP_REQUEST, ((millis() - startTime) / 1000));
-                _dhcp_state = STATE_DHCP_REQUEST;
+            _dhcp_state = STATE_DHCP_LEASED;
+            result = DHCP_STEP_LEASED;
+            //use default lease time if we didn't get it
+            if(_dhcpLeaseTime == 0){
+                _dhcpLeaseTime = DEFAULT_LEASE;
             }
-        }
-        else if(_dhcp_state == STATE_DHCP_REQUEST)
-        {
-            uint32_t respId;
-            messageType = parseDHCPResponse(_responseTimeout, respId);
-            if(messageType == DHCP_ACK)
-            {
-                _dhcp_state = STATE_DHCP_LEASED;
-                result = 1;
-                //use default lease time if we didn't get it
-                if(_dhcpLeaseTime == 0){
-                    _dhcpLeaseTime = DEFAULT_LEASE;
-                }
-                //calculate T1 & T2 if we didn't get it
-                if(_dhcpT1 == 0){
-                    //T1 should be 50% of _dhcpLeaseTime
-                    _dhcpT1 = _dhcpLeaseTime >> 1;
-                }
-                if(_dhcpT2 == 0){
-                    //T2 should be 87.5% (7/8ths) of _dhcpLeaseTime
-                    _dhcpT2 = _dhcpT1 << 1;
-                }
-                _renewInSec = _dhcpT1;
-                _rebindInSec = _dhcpT2;
+            //calculate T1 & T2 if we didn't get it
+            if(_dhcpT1 == 0){
+                //T1 should be 50% of _dhcpLeaseTime
+                _dhcpT1 = _dhcpLeaseTime >> 1;
             }
-            else if(messageType == DHCP_NAK)
-                _dhcp_state = STATE_DHCP_START;
+            if(_dhcpT2 == 0){
+                //T2 should be 87.5% (7/8ths) of _dhcpLeaseTime
+                _dhcpT2 = _dhcpT1 << 1;
+            }
+            _renewInSec = _dhcpT1;
+            _rebindInSec = _dhcpT2;
         }
-        
-        if(messageType == 255)
-        {
-            messageType = 0;
+        else if(messageType == DHCP_NAK)
             _dhcp_state = STATE_DHCP_START;
-        }
-        
-        if(result != 1 && ((millis() - startTime) > _timeout))
-            break;
     }
-    
-    // We're done with the socket now
-    _dhcpUdpSocket.stop();
-    _dhcpTransactionId++;
+
+    // no answer from the server, start again with a discover
+    if(result != DHCP_STEP_LEASED && (_dhcp_state == STATE_DHCP_DISCOVER || _dhcp_state == STATE_DHCP_REQUEST)
+        && ((now - _responseStart) > _responseTimeout))
+    {
+        _dhcp_state = STATE_DHCP_START;
+    }
+
+    if(result != DHCP_STEP_LEASED && ((now - _requestStart) > _timeout))
+        result = DHCP_STEP_FAILED;
+
+    if(result != DHCP_STEP_BUSY)
+    {
+        // We're done with the socket now
+        _dhcpUdpSocket.stop();
+        _dhcpTransactionId++;
+        _requestRunning = false;
+    }
 
     return result;
 }
@@ -262,23 +284,15 @@ void DhcpClass::send_DHCP_MESSAGE(uint8_t messageType, uint16_t secondsElapsed)
     _dhcpUdpSocket.endPacket();
 }
 
-uint8_t DhcpClass::parseDHCPResponse(unsigned long responseTimeout, uint32_t& transactionId)
+uint8_t DhcpClass::parseDHCPResponse(uint32_t& transactionId)
 {
     uint8_t type = 0;
     uint8_t opt_len = 0;
-	
-    unsigned long startTime = millis();
-    
-	
-	
-    while(_dhcpUdpSocket.parsePacket() <= 0)
+
+    // nothing received yet, the caller handles the response timeout
+    if(_dhcpUdpSocket.parsePacket() <= 0)
     {
-        if((millis() - startTime) > responseTimeout)
-        {
-            
-			return 255;
-        }
-        delay(50);
+        return 0;
     }
 	
     // start reading in the packet
@@ -419,12 +433,51 @@ void DhcpClass::setCustomHostname(char* hostname)
     2/DHCP_CHECK_RENEW_OK: renew success
     3/DHCP_CHECK_REBIND_FAIL: rebind fail
     4/DHCP_CHECK_REBIND_OK: rebind success
+    5/DHCP_CHECK_LEASE_FAIL: first lease failed, it is requested again
+    6/DHCP_CHECK_LEASE_OK: first lease success
+    A running request is advanced by one step, so this never blocks.
 */
 int DhcpClass::checkLease(){
     //this uses a signed / unsigned trick to deal with millis overflow
     unsigned long now = millis();
     signed long snow = (long)now;
     int rc=DHCP_CHECK_NONE;
+
+    if (_leasePending != DHCP_LEASE_NONE){
+        uint8_t result = step_DHCP_lease();
+        if (result != DHCP_STEP_BUSY){
+            bool leased = (result == DHCP_STEP_LEASED);
+            // T1 and T2 count from the new lease, not from the last check before the request
+            if (leased) _secTimeout = snow + 1000;
+            if (_leasePending == DHCP_LEASE_INITIAL){
+                rc = leased ? DHCP_CHECK_LEASE_OK : DHCP_CHECK_LEASE_FAIL;
+                if (!leased) _dhcp_state = STATE_DHCP_START; // try again
+                else _leasePending = DHCP_LEASE_NONE;
+            }
+            else {
+                if (_leasePending == DHCP_LEASE_RENEW){
+                    rc = leased ? DHCP_CHECK_RENEW_OK : DHCP_CHECK_RENEW_FAIL;
+                    // the old lease is valid until the rebind time, try again after
+                    // half of the time to T2, at least 60s, like RFC 2131 4.4.5
+                    if (!leased){
+                        _dhcp_state = STATE_DHCP_LEASED;
+                        _renewInSec = _rebindInSec / 2;
+                        if (_renewInSec < DHCP_RENEW_RETRY_MIN) _renewInSec = DHCP_RENEW_RETRY_MIN;
+                    }
+                }
+                else {
+                    rc = leased ? DHCP_CHECK_REBIND_OK : DHCP_CHECK_REBIND_FAIL;
+                    if (!leased) _dhcp_state = STATE_DHCP_START;
+                }
+                _leasePending = DHCP_LEASE_NONE;
+            }
+        }
+        if (_leasePending == DHCP_LEASE_INITIAL){
+            _lastCheck = now;
+            return rc;
+        }
+    }
+
     if (_lastCheck != 0){
         signed long factor;
         //calc how many ms past the timeout we are
@@ -451,18 +504,20 @@ int DhcpClass::checkLease(){
                 _rebindInSec -= factor;
         }
 
-        //if we have a lease but should renew, do it
-        if (_dhcp_state == STATE_DHCP_LEASED && _renewInSec <=0){
-            _dhcp_state = STATE_DHCP_REREQUEST;
-            rc = 1 + request_DHCP_lease();
-        }
+        if (_leasePending == DHCP_LEASE_NONE && rc == DHCP_CHECK_NONE){
+            //if we have a lease but should renew, start it
+            if (_dhcp_state == STATE_DHCP_LEASED && _renewInSec <=0 && _rebindInSec > 0){
+                _dhcp_state = STATE_DHCP_REREQUEST;
+                _leasePending = DHCP_LEASE_RENEW;
+            }
 
-        //if we have a lease or is renewing but should bind, do it
-        if( (_dhcp_state == STATE_DHCP_LEASED || _dhcp_state == STATE_DHCP_START) && _rebindInSec <=0){
-            //this should basically restart completely
-            _dhcp_state = STATE_DHCP_START;
-            reset_DHCP_lease();
-            rc = 3 + request_DHCP_lease();
+            //if we have a lease or is renewing but should bind, start it
+            else if( (_dhcp_state == STATE_DHCP_LEASED || _dhcp_state == STATE_DHCP_START) && _rebindInSec <=0){
+                //this should basically restart completely
+                _dhcp_state = STATE_DHCP_START;
+                reset_DHCP_lease();
+                _leasePending = DHCP_LEASE_REBIND;
+            }
         }
     }
     else{
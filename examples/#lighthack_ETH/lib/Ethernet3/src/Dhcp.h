@@ -46,12 +46,26 @@
 
 #define HOST_NAME "WIZnet"
 #define DEFAULT_LEASE	(900) //default lease time in seconds
+#define DHCP_RENEW_RETRY_MIN	(60) //min time in seconds before a failed renew is tried again
 
 #define DHCP_CHECK_NONE         (0)
 #define DHCP_CHECK_RENEW_FAIL   (1)
 #define DHCP_CHECK_RENEW_OK     (2)
 #define DHCP_CHECK_REBIND_FAIL  (3)
 #define DHCP_CHECK_REBIND_OK    (4)
+#define DHCP_CHECK_LEASE_FAIL   (5)
+#define DHCP_CHECK_LEASE_OK     (6)
+
+/* result of a single step of the lease request */
+#define DHCP_STEP_BUSY    0
+#define DHCP_STEP_LEASED  1
+#define DHCP_STEP_FAILED  2
+
+/* kind of the lease request running in the background */
+#define DHCP_LEASE_NONE     0
+#define DHCP_LEASE_INITIAL  1
+#define DHCP_LEASE_RENEW    2
+#define DHCP_LEASE_REBIND   3
 
 enum
 {
@@ -156,15 +170,20 @@ private:
   unsigned long _timeout;
   unsigned long _responseTimeout;
   unsigned long _secTimeout;
+  unsigned long _requestStart;
+  unsigned long _responseStart;
   uint8_t _dhcp_state;
+  uint8_t _leasePending;
+  bool _requestRunning;
   EthernetUDP _dhcpUdpSocket;
   int request_DHCP_lease();
+  uint8_t step_DHCP_lease();
   void reset_DHCP_lease();
   void presend_DHCP();
   void send_DHCP_MESSAGE(uint8_t, uint16_t);
   void printByte(char *, uint8_t);
 
-  uint8_t parseDHCPResponse(unsigned long responseTimeout, uint32_t& transactionId);
+  uint8_t parseDHCPResponse(uint32_t& transactionId);
 public:
   IPAddress getLocalIp();
   IPAddress getSubnetMask();
@@ -173,6 +192,9 @@ public:
   IPAddress getDnsServerIp();
 
   int beginWithDHCP(uint8_t *, unsigned long timeout = 60000, unsigned long responseTimeout = 5000);
+  // starts the lease request and returns immediately, checkLease() advances it
+  void startDHCP(uint8_t *, unsigned long timeout = 60000, unsigned long responseTimeout = 5000);
+  bool leased() { return _dhcp_state == STATE_DHCP_LEASED || _leasePending == DHCP_LEASE_RENEW; }
   int checkLease();
   void setCustomHostname(char* hostname);
 };
@@ -43,15 +43,124 @@
 
 // Possible return codes from ProcessResponse
 #define SUCCESS          1
+#define PENDING          0
 #define TIMED_OUT        -1
 #define INVALID_SERVER   -2
 #define TRUNCATED        -3
 #define INVALID_RESPONSE -4
+#define NO_SOCKET        -7
+#define SEND_FAILED      -8
+#define NAME_TOO_LONG    -11
+
+#if DNS_CACHE_SIZE > 0
+DNSClient::CacheEntry* DNSClient::iCache = NULL;
+#endif
+uint32_t DNSClient::iCacheHits = 0;
+uint32_t DNSClient::iCacheMisses = 0;
 
 void DNSClient::begin(const IPAddress& aDNSServer)
 {
     iDNSServer = aDNSServer;
     iRequestId = 0;
+    iPendingName = NULL;
+}
+
+bool DNSClient::cacheLookup(const char* aHostname, IPAddress& aResult)
+{
+#if DNS_CACHE_SIZE > 0
+    unsigned long now = millis();
+    for (uint8_t i = 0; iCache && i < DNS_CACHE_SIZE; i++)
+    {
+        CacheEntry& entry = iCache[i];
+        if (entry.ttl == 0 || strncmp(entry.name, aHostname, DNS_CACHE_NAME_LEN) != 0)
+            continue;
+        // the difference stays right when millis() wraps around, an expired
+        // entry is kept for cacheStale() until the new answer replaces it
+        if ((now - entry.stored) >= entry.ttl)
+            break;
+        aResult = entry.address;
+        iCacheHits++;
+        return true;
+    }
+#endif
+    iCacheMisses++;
+    return false;
+}
+
+bool DNSClient::cacheStale(const char* aHostname, IPAddress& aResult)
+{
+#if DNS_CACHE_SIZE > 0
+    for (uint8_t i = 0; iCache && i < DNS_CACHE_SIZE; i++)
+    {
+        CacheEntry& entry = iCache[i];
+        if (entry.ttl != 0 && strncmp(entry.name, aHostname, DNS_CACHE_NAME_LEN) == 0)
+        {
+            aResult = entry.address;
+            return true;
+        }
+    }
+#else
+    (void)aHostname;
+    (void)aResult;
+#endif
+    return false;
+}
+
+void DNSClient::cacheStore(const char* aHostname, const IPAddress& aAddress, uint32_t aTtl)
+{
+#if DNS_CACHE_SIZE > 0
+    if (aTtl == 0 || strlen(aHostname) >= DNS_CACHE_NAME_LEN)
+        return;
+    if (aTtl > DNS_CACHE_MAX_TTL)
+        aTtl = DNS_CACHE_MAX_TTL;
+    if (!iCache)
+    {
+        // a sketch which never resolves a name doesn't pay for the cache
+        iCache = new CacheEntry[DNS_CACHE_SIZE];
+        if (!iCache)
+            return;
+        for (uint8_t i = 0; i < DNS_CACHE_SIZE; i++)
+            iCache[i].ttl = 0;
+    }
+    unsigned long now = millis();
+    // reuse the entry of the same name, else a free one, else the oldest one
+    uint8_t slot = 0;
+    unsigned long oldest = 0;
+    for (uint8_t i = 0; i < DNS_CACHE_SIZE; i++)
+    {
+        CacheEntry& entry = iCache[i];
+        if (entry.ttl != 0 && strcmp(entry.name, aHostname) == 0)
+        {
+            slot = i;
+            break;
+        }
+        unsigned long age = entry.ttl == 0 ? 0xFFFFFFFFUL : now - entry.stored;
+        if (age >= oldest)
+        {
+            oldest = age;
+            slot = i;
+        }
+    }
+    CacheEntry& entry = iCache[slot];
+    strcpy(entry.name, aHostname);
+    entry.address = aAddress;
+    entry.stored = now;
+    entry.ttl = aTtl * 1000UL;
+#else
+    (void)aHostname;
+    (void)aAddress;
+    (void)aTtl;
+#endif
+}
+
+void DNSClient::cacheClear()
+{
+#if DNS_CACHE_SIZE > 0
+    for (uint8_t i = 0; iCache && i < DNS_CACHE_SIZE; i++)
+        iCache[i].ttl = 0;
+#endif
+    iCacheHits = 0;
+    iCacheMisses = 0;
 }
 
 
@@ -60,7 +169,7 @@ int DNSClient::inet_aton(const char* aIPAddrString, IPAddress& aResult)
     // See if we've been given a valid IP address
     const char* p =aIPAddrString;
     while (*p &&
-           ( (*p == '.') || (*p >= '0') || (*p <= '9') ))
+           ( (*p == '.') || ((*p >= '0') && (*p <= '9')) ))
     {
         p++;
     }
@@ -117,8 +226,6 @@ int DNSClient::inet_aton(const char* aIPAddrString, IPAddress& aResult)
 
 int DNSClient::getHostByName(const char* aHostname, IPAddress& aResult)
 {
-    int ret =0;
-
     // See if it's a numeric IP address
     if (inet_aton(aHostname, aResult))
     {
@@ -126,52 +233,113 @@ int DNSClient::getHostByName(const char* aHostname, IPAddress& aResult)
         return 1;
     }
 
-    // Check we've got a valid DNS server to use
-    if (iDNSServer == INADDR_NONE)
+    if (cacheLookup(aHostname, aResult))
     {
-        return INVALID_SERVER;
+        return 1;
     }
-	
-    // Find a socket to use
-    if (iUdp.begin(1024+(millis() & 0xF)) == 1)
+
+    int ret;
+    do
     {
-        // Try up to three times
-        int retries = 0;
-//        while ((retries < 3) && (ret <= 0))
+        ret = resolve(aHostname, aResult);
+    } while (ret == PENDING);
+    return ret;
+}
+
+int DNSClient::resolve(const char* aHostname, IPAddress& aResult)
+{
+    if (iPendingName == NULL)
+    {
+        if (inet_aton(aHostname, aResult))
         {
-            // Send DNS request
-            ret = iUdp.beginPacket(iDNSServer, DNS_PORT);
-            if (ret != 0)
-            {
-                // Now output the request data
-                ret = BuildRequest(aHostname);
-                if (ret != 0)
-                {
-                    // And finally send the request
-                    ret = iUdp.endPacket();
-                    if (ret != 0)
-                    {
-                        // Now wait for a response
-                        int wait_retries = 0;
-                        ret = TIMED_OUT;
-                        while ((wait_retries < 3) && (ret == TIMED_OUT))
-                        {
-                            ret = ProcessResponse(5000, aResult);
-                            wait_retries++;
-                        }
-                    }
-                }
-            }
-            retries++;
+            return 1;
+        }
+
+        // the name is kept during the lookup, the caller's buffer may be gone then
+        if (strlen(aHostname) >= DNS_NAME_LEN)
+        {
+            return NAME_TOO_LONG;
         }
 
-        // We're done with the socket now
-        iUdp.stop();
+        // Check we've got a valid DNS server to use
+        if (iDNSServer == INADDR_NONE)
+        {
+            return INVALID_SERVER;
+        }
+
+        // Find a socket to use
+        if (iUdp.begin(1024+(millis() & 0xF)) != 1)
+        {
+            return NO_SOCKET;
+        }
+
+        strcpy(iHostname, aHostname);
+        iPendingName = iHostname;
+        iRetries = 0;
+        if (SendRequest() == 0)
+        {
+            Finish();
+            return SEND_FAILED;
+        }
+        return PENDING;
+    }
+
+    // another name is being resolved, the caller must come again
+    if (strcmp(iPendingName, aHostname) != 0)
+    {
+        return PENDING;
+    }
+
+    uint32_t ttl = 0;
+    int ret = ProcessResponse(aResult, ttl);
+    if (ret == PENDING || ret == INVALID_SERVER || ret == INVALID_RESPONSE)
+    {
+        // nothing for us yet, or a late answer to an earlier request
+        if ((millis() - iSentAt) <= DNS_TIMEOUT)
+        {
+            return PENDING;
+        }
+        // Try up to three times
+        if (++iRetries < 3 && SendRequest() != 0)
+        {
+            return PENDING;
+        }
+        ret = TIMED_OUT;
+    }
+    else if (ret == SUCCESS)
+    {
+        cacheStore(iPendingName, aResult, ttl);
     }
 
+    Finish();
     return ret;
 }
 
+int DNSClient::SendRequest()
+{
+    // Send DNS request
+    int ret = iUdp.beginPacket(iDNSServer, DNS_PORT);
+    if (ret != 0)
+    {
+        // Now output the request data
+        ret = BuildRequest(iPendingName);
+        if (ret != 0)
+        {
+            // And finally send the request
+            ret = iUdp.endPacket();
+        }
+    }
+    iSentAt = millis();
+    return ret;
+}
+
+void DNSClient::Finish()
+{
+    // We're done with the socket now
+    iUdp.stop();
+    iPendingName = NULL;
+}
+
 uint16_t DNSClient::BuildRequest(const char* aName)
 {
     // Build header
@@ -252,16 +420,12 @@ uint16_t DNSClient::BuildRequest(const char* aName)
 }
 
 
-uint16_t DNSClient::ProcessResponse(uint16_t aTimeout, IPAddress& aAddress)
+int DNSClient::ProcessResponse(IPAddress& aAddress, uint32_t& aTtl)
 {
-    uint32_t startTime = millis();
-
-    // Wait for a response packet
-    while(iUdp.parsePacket() <= 0)
+    // Look for a response packet, the caller handles the timeout
+    if(iUdp.parsePacket() <= 0)
     {
-        if((millis() - startTime) > aTimeout)
-            return TIMED_OUT;
-        delay(50);
+        return PENDING;
     }
 
     // We've had a reply!
@@ -272,12 +436,14 @@ uint16_t DNSClient::ProcessResponse(uint16_t aTimeout, IPAddress& aAddress)
         (iUdp.remotePort() != DNS_PORT) )
     {
         // It's not from who we expected
+        iUdp.flush();
         return INVALID_SERVER;
     }
 
     // Read through the rest of the response
     if (iUdp.available() < DNS_HEADER_SIZE)
     {
+        iUdp.flush();
         return TRUNCATED;
     }
     iUdp.read(header, DNS_HEADER_SIZE);
@@ -382,11 +548,9 @@ uint16_t DNSClient::ProcessResponse(uint16_t aTimeout, IPAddress& aAddress)
         iUdp.read((uint8_t*)&answerType, sizeof(answerType));
         iUdp.read((uint8_t*)&answerClass, sizeof(answerClass));
 
-        // Ignore the Time-To-Live as we don't do any caching
-        for (int i =0; i < TTL_SIZE; i++)
-        {
-            iUdp.read(); // we don't care about the returned byte
-        }
+        // The Time-To-Live tells how long the answer may be cached
+        uint8_t ttl[TTL_SIZE];
+        iUdp.read(ttl, TTL_SIZE);
 
         // And read out the length of this answer
         // Don't need header_flags anymore, so we can reuse it here
@@ -402,6 +566,8 @@ uint16_t DNSClient::ProcessResponse(uint16_t aTimeout, IPAddress& aAddress)
                 return -9;//INVALID_RESPONSE;
             }
             iUdp.read(aAddress.raw_address(), 4);
+            aTtl = ((uint32_t)ttl[0] << 24) | ((uint32_t)ttl[1] << 16) | ((uint16_t)ttl[2] << 8) | ttl[3];
+            iUdp.flush();
             return SUCCESS;
         }
         else
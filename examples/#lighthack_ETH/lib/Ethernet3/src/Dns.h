@@ -7,9 +7,40 @@
 
 #include <EthernetUdp3.h>
 
+// number of resolved hostnames kept, 0 disables the cache
+#ifndef DNS_CACHE_SIZE
+#define DNS_CACHE_SIZE 4
+#endif
+// longer hostnames are resolved but not cached
+#ifndef DNS_CACHE_NAME_LEN
+#define DNS_CACHE_NAME_LEN 32
+#endif
+// longest hostname which can be resolved, the name is copied for the background lookup
+#ifndef DNS_NAME_LEN
+#define DNS_NAME_LEN 64
+#endif
+// upper limit for the TTL given by the server, in seconds
+#ifndef DNS_CACHE_MAX_TTL
+#define DNS_CACHE_MAX_TTL 3600UL
+#endif
+// time to wait for an answer before the request is sent again, in ms
+#ifndef DNS_TIMEOUT
+#define DNS_TIMEOUT 5000
+#endif
+
+// errors of resolve(), getHostByName() and EthernetUDP::beginPacket(host, port)
+#define DNS_TIMED_OUT       -1
+#define DNS_INVALID_SERVER  -2
+#define DNS_TRUNCATED       -3
+#define DNS_INVALID_RESPONSE -4
+#define DNS_NO_SOCKET       -7
+#define DNS_SEND_FAILED     -8
+#define DNS_NAME_TOO_LONG   -11 // -5, -6, -9 and -10 are invalid answers
+
 class DNSClient
 {
 public:
+    DNSClient() : iRequestId(0), iPendingName(NULL) {}
     // ctor
     void begin(const IPAddress& aDNSServer);
 
@@ -19,7 +50,7 @@ public:
         @result 1 if aIPAddrString was successfully converted to an IP address,
                 else error code
     */
-    int inet_aton(const char *aIPAddrString, IPAddress& aResult);
+    static int inet_aton(const char *aIPAddrString, IPAddress& aResult);
 
     /** Resolve the given hostname to an IP address.
         @param aHostname Name to be resolved
@@ -29,13 +60,57 @@ public:
     */
     int getHostByName(const char* aHostname, IPAddress& aResult);
 
+    /** Resolve the given hostname without blocking, call it again until it
+        returns something other than 0. Only one lookup runs at a time, a call
+        with another hostname returns 0 until the running lookup is done.
+        @param aHostname Name to be resolved
+        @param aResult IPAddress structure to store the returned IP address
+        The name is copied, so it may be a temporary buffer.
+        @result 1 if resolved, 0 if the lookup is still running, else error code,
+                -11 if the name has DNS_NAME_LEN or more characters
+    */
+    int resolve(const char* aHostname, IPAddress& aResult);
+    bool busy() { return iPendingName != NULL; } // a lookup is running
+
+    /** Look up a hostname in the cache of resolved names.
+        @result true if there is an entry whose TTL has not expired
+    */
+    static bool cacheLookup(const char* aHostname, IPAddress& aResult);
+    /** Look up a hostname in the cache also if its TTL has expired, the last
+        known address is used while the name is resolved again.
+        @result true if the name was resolved before
+    */
+    static bool cacheStale(const char* aHostname, IPAddress& aResult);
+    static void cacheClear();
+    static uint32_t cacheHits() { return iCacheHits; }
+    static uint32_t cacheMisses() { return iCacheMisses; }
+
 protected:
     uint16_t BuildRequest(const char* aName);
-    uint16_t ProcessResponse(uint16_t aTimeout, IPAddress& aAddress);
+    int SendRequest();
+    int ProcessResponse(IPAddress& aAddress, uint32_t& aTtl);
+    void Finish();
+    static void cacheStore(const char* aHostname, const IPAddress& aAddress, uint32_t aTtl);
 
     IPAddress iDNSServer;
     uint16_t iRequestId;
     EthernetUDP iUdp;
+    char iHostname[DNS_NAME_LEN];
+    const char* iPendingName; // iHostname while a lookup runs, NULL if idle
+    unsigned long iSentAt;
+    uint8_t iRetries;
+
+    struct CacheEntry {
+        char name[DNS_CACHE_NAME_LEN];
+        IPAddress address;
+        unsigned long stored; // millis() when stored
+        unsigned long ttl; // in ms, 0 marks an unused entry
+    };
+#if DNS_CACHE_SIZE > 0
+    static CacheEntry* iCache; // allocated when the first name is stored
+#endif
+    static uint32_t iCacheHits;
+    static uint32_t iCacheMisses;
 };
 
 #endif
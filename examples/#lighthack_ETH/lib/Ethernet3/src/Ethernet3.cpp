@@ -14,6 +14,13 @@
 // XXX: don't make assumptions about the value of MAX_SOCK_NUM.
 uint8_t EthernetClass::_state[MAX_SOCK_NUM] = { 0, };
 uint16_t EthernetClass::_server_port[MAX_SOCK_NUM] = { 0, };
+volatile bool EthernetClass::_intFlag = false;
+uint8_t EthernetClass::_intSockets = 0;
+
+// no SPI access here, a transaction in the ISR would collide with one in the loop
+static void w5500Interrupt() {
+  EthernetClass::_intFlag = true;
+  }
 
 void EthernetClass::setRstPin(uint8_t pinRST) {
   _pinRST = pinRST;
@@ -24,10 +31,42 @@ void EthernetClass::setCsPin(uint8_t pinCS) {
   _pinCS = pinCS;
   }
 
+void EthernetClass::setSpiClock(uint32_t clock) {
+  w5500.setSpiClock(clock);
+  }
+
+void EthernetClass::setIntPin(uint8_t pinINT) {
+  if (digitalPinToInterrupt(pinINT) == NOT_AN_INTERRUPT) return;
+  _pinINT = pinINT;
+  pinMode(_pinINT, INPUT_PULLUP);
+  _intFlag = true; // forces a first look at SIR
+  attachInterrupt(digitalPinToInterrupt(_pinINT), w5500Interrupt, FALLING);
+  }
+
+bool EthernetClass::socketInterrupt(SOCKET s) {
+  if (_intFlag) {
+    _intFlag = false;
+    _intSockets |= w5500.readSIR();
+    }
+  return bitRead(_intSockets, s);
+  }
+
+void EthernetClass::clearSocketInterrupt(SOCKET s) {
+  bitClear(_intSockets, s);
+  // INTn is held low as long as any socket has a pending interrupt,
+  // so there is no new edge for the ISR, check the level instead
+  if (digitalRead(_pinINT) == LOW) _intFlag = true;
+  }
+
 void EthernetClass::init(uint8_t maxSockNum) {
   _maxSockNum = maxSockNum;
   }
 
+void EthernetClass::init(const uint8_t *rxSizes, const uint8_t *txSizes) {
+  _rxSizes = rxSizes;
+  _txSizes = txSizes;
+  }
+
 uint8_t EthernetClass::softreset() {
   return w5500.softReset();
   }
@@ -37,7 +76,7 @@ void EthernetClass::hardreset() {
     digitalWrite(_pinRST, LOW);
     delay(1);
     digitalWrite(_pinRST, HIGH);
-    delay(150);
+    w5500.waitReady(150);
     }
   }
 
@@ -49,7 +88,7 @@ int EthernetClass::begin(void)
   _dhcp = new DhcpClass();
 
   // Initialise the basic info
-  w5500.init(_maxSockNum, _pinCS);
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
   w5500.setIPAddress(IPAddress(0,0,0,0).raw_address());
   w5500.getMACAddress(mac_address);
 
@@ -72,6 +111,24 @@ int EthernetClass::begin(void)
   return ret;
 }
 
+void EthernetClass::beginAsync(void)
+{
+  uint8_t mac_address[6] ={0,};
+  if (_dhcp == NULL) _dhcp = new DhcpClass();
+
+  // Initialise the basic info
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
+  w5500.setIPAddress(IPAddress(0,0,0,0).raw_address());
+  w5500.getMACAddress(mac_address);
+
+  if (strlen(_customHostname) != 0)
+  {
+    _dhcp->setCustomHostname(_customHostname);
+  }
+
+  _dhcp->startDHCP(mac_address);
+}
+
 void EthernetClass::begin(IPAddress local_ip)
 {
   IPAddress subnet(255, 255, 255, 0);
@@ -98,7 +155,7 @@ void EthernetClass::begin(IPAddress local_ip, IPAddress subnet, IPAddress gatewa
 
 void EthernetClass::begin(IPAddress local_ip, IPAddress subnet, IPAddress gateway, IPAddress dns_server)
 {
-  w5500.init(_maxSockNum, _pinCS);
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
   w5500.setIPAddress(local_ip.raw_address());
   w5500.setGatewayIp(gateway.raw_address());
   w5500.setSubnetMask(subnet.raw_address());
@@ -110,7 +167,7 @@ int EthernetClass::begin(uint8_t *mac_address)
 {
   _dhcp = new DhcpClass();
   // Initialise the basic info
-  w5500.init(_maxSockNum, _pinCS);
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
   w5500.setMACAddress(mac_address);
   w5500.setIPAddress(IPAddress(0,0,0,0).raw_address());
 
@@ -134,6 +191,22 @@ int EthernetClass::begin(uint8_t *mac_address)
   return ret;
 }
 
+void EthernetClass::beginAsync(uint8_t *mac_address)
+{
+  if (_dhcp == NULL) _dhcp = new DhcpClass();
+  // Initialise the basic info
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
+  w5500.setMACAddress(mac_address);
+  w5500.setIPAddress(IPAddress(0,0,0,0).raw_address());
+
+  if (strlen(_customHostname) != 0)
+  {
+    _dhcp->setCustomHostname(_customHostname);
+  }
+
+  _dhcp->startDHCP(mac_address);
+}
+
 void EthernetClass::begin(uint8_t *mac_address, IPAddress local_ip)
 {
   IPAddress subnet(255, 255, 255, 0);
@@ -160,7 +233,7 @@ void EthernetClass::begin(uint8_t *mac_address, IPAddress local_ip, IPAddress su
 
 void EthernetClass::begin(uint8_t *mac, IPAddress local_ip, IPAddress subnet, IPAddress gateway, IPAddress dns_server)
 {
-  w5500.init(_maxSockNum, _pinCS);
+  w5500.init(_maxSockNum, _pinCS, _rxSizes, _txSizes);
   w5500.setMACAddress(mac);
   w5500.setIPAddress(local_ip.raw_address());
   w5500.setGatewayIp(gateway.raw_address());
@@ -179,6 +252,7 @@ int EthernetClass::maintain(){
       case DHCP_CHECK_NONE:
         //nothing done
         break;
+      case DHCP_CHECK_LEASE_OK:
       case DHCP_CHECK_RENEW_OK:
       case DHCP_CHECK_REBIND_OK:
         //we might have got a new IP.
@@ -195,6 +269,10 @@ int EthernetClass::maintain(){
   return rc;
 }
 
+bool EthernetClass::dhcpLeased() {
+  return _dhcp != NULL && _dhcp->leased();
+  }
+
 void EthernetClass::WoL(bool wol) { 
   uint8_t val = w5500.readMR();
   bitWrite(val, 5, wol);
@@ -36,14 +36,24 @@ public:
   uint8_t _maxSockNum;
   uint8_t _pinCS;
   uint8_t _pinRST;
+  uint8_t _pinINT;
+  const uint8_t *_rxSizes;
+  const uint8_t *_txSizes;
 
   static uint8_t _state[MAX_SOCK_NUM];
   static uint16_t _server_port[MAX_SOCK_NUM];
+  static volatile bool _intFlag; // latched by the ISR on the falling edge of INTn
+  static uint8_t _intSockets; // sockets with a pending interrupt, from SIR
 
-  EthernetClass() { _dhcp = NULL; _pinCS = 10; _maxSockNum = 8; }
+  EthernetClass() { _dhcp = NULL; _pinCS = 10; _pinINT = 0; _maxSockNum = 8; _rxSizes = NULL; _txSizes = NULL; }
 
   void setRstPin(uint8_t pinRST = 9); // for WIZ550io or USR-ES1, must set befor Ethernet.begin
   void setCsPin(uint8_t pinCS = 10); // must set befor Ethernet.begin
+  void setSpiClock(uint32_t clock = W5500_SPI_CLOCK); // SPI clock in Hz, the default depends on the board
+  void setIntPin(uint8_t pinINT = 2); // INTn of the W5500, must be an interrupt capable pin, set befor udp.begin
+  bool interruptMode() { return _pinINT != 0; } // returns true if the INTn pin is used
+  bool socketInterrupt(SOCKET s); // returns true if there is a pending interrupt for the socket
+  void clearSocketInterrupt(SOCKET s); // clears the pending interrupt of the socket
 
   // Initialize with less sockets but more RX/TX Buffer
   // maxSockNum = 1 Socket 0 -> RX/TX Buffer 16k
@@ -53,6 +63,12 @@ public:
   // be carefull of the MAX_SOCK_NUM, because in the moment it can't dynamicly changed
   void init(uint8_t maxSockNum = 8);
 
+  // Initialize with individual RX/TX Buffer sizes in KB for every socket
+  // possible sizes are 0, 1, 2, 4, 8, 16 and the sum of each array must not exceed 16
+  // e.g. give the first socket, used for OSC, a larger RX buffer
+  // uint8_t rx[8] = {8, 2, 2, 1, 1, 1, 1, 0};
+  void init(const uint8_t *rxSizes, const uint8_t *txSizes);
+
   uint8_t softreset(); // can set only after Ethernet.begin
   void hardreset(); // You need to set the Rst pin
 
@@ -67,6 +83,8 @@ public:
   void begin(IPAddress local_ip, IPAddress subnet);
   void begin(IPAddress local_ip, IPAddress subnet, IPAddress gateway);
   void begin(IPAddress local_ip, IPAddress subnet, IPAddress gateway, IPAddress dns_server);
+  // Starts DHCP and returns immediately, Ethernet.maintain() gets the lease in the loop
+  void beginAsync(void);
 #else
   // Initialize the Ethernet shield to use the provided MAC address and gain the rest of the
   // configuration through DHCP.
@@ -76,9 +94,13 @@ public:
   void begin(uint8_t *mac_address, IPAddress local_ip, IPAddress subnet);
   void begin(uint8_t *mac_address, IPAddress local_ip, IPAddress subnet, IPAddress gateway);
   void begin(uint8_t *mac_address, IPAddress local_ip, IPAddress subnet, IPAddress gateway, IPAddress dns_server);
+  // Starts DHCP and returns immediately, Ethernet.maintain() gets the lease in the loop
+  void beginAsync(uint8_t *mac_address);
 #endif
 
+  // Advances DHCP without blocking, returns one of the DHCP_CHECK_ codes
   int maintain();
+  bool dhcpLeased(); // true if DHCP is used and has a lease
   void WoL(bool wol); // set Wake on LAN
   bool WoL(); // get the WoL state
   void phyMode(phyMode_t mode); // set PHYCFGR
@@ -14,10 +14,10 @@ extern "C" {
 
 uint16_t EthernetClient::_srcport = 49152; //Use IANA recommended ephemeral port range 49152-65535
 
-EthernetClient::EthernetClient() : _sock(MAX_SOCK_NUM) {
+EthernetClient::EthernetClient() : _sock(MAX_SOCK_NUM), _timeout(CLIENT_WAIT) {
 }
 
-EthernetClient::EthernetClient(uint8_t sock) : _sock(sock) {
+EthernetClient::EthernetClient(uint8_t sock) : _sock(sock), _timeout(CLIENT_WAIT) {
 }
 
 int EthernetClient::connect(const char* host, uint16_t port) {
@@ -59,12 +59,20 @@ int EthernetClient::connect(IPAddress ip, uint16_t port) {
     return 0;
   }
 
+  if (_timeout == 0) return 1; // connected() tells when it is established
+
+  unsigned long start = millis();
   while (status() != SnSR::ESTABLISHED) {
     delay(1);
     if (status() == SnSR::CLOSED) {
       _sock = MAX_SOCK_NUM;
       return 0;
     }
+    if (_timeout != CLIENT_WAIT && millis() - start > _timeout) {
+      close(_sock);
+      _sock = MAX_SOCK_NUM;
+      return 0;
+    }
   }
 
   return 1;
@@ -127,12 +135,20 @@ void EthernetClient::stop() {
   if (_sock == MAX_SOCK_NUM)
     return;
 
+  // a connection which isn't established yet, e.g. after connect() without waiting, is closed at once
+  uint8_t s = status();
+  if (s == SnSR::INIT || s == SnSR::SYNSENT || s == SnSR::CLOSED) {
+    close(_sock);
+    EthernetClass::_server_port[_sock] = 0;
+    _sock = MAX_SOCK_NUM;
+    return;
+  }
+
   // attempt to close the connection gracefully (send a FIN to other side)
   disconnect(_sock);
   unsigned long start = millis();
 
   // wait a second for the connection to close
-  uint8_t s;
    do {
      s = status();
      if (s == SnSR::CLOSED)
@@ -153,6 +169,7 @@ uint8_t EthernetClient::connected() {
 
   uint8_t s = status();
   return !(s == SnSR::LISTEN || s == SnSR::CLOSED || s == SnSR::FIN_WAIT ||
+    s == SnSR::INIT || s == SnSR::SYNSENT || // connect() without waiting
     (s == SnSR::CLOSE_WAIT && !available()));
 }
 
@@ -195,6 +212,10 @@ void EthernetClient::setNoDelayedACK(bool ack) {
   w5500.writeSnMR(_sock, value);
 }
 
+void EthernetClient::setConnectionTimeout(uint16_t timeout) {
+  _timeout = timeout;
+}
+
 bool EthernetClient::getNoDelayedACK() {
   uint8_t value;
   value = w5500.readSnMR(_sock);
@@ -5,6 +5,8 @@
 #include "Client.h"
 #include "IPAddress.h"
 
+#define CLIENT_WAIT 0xFFFF // wait until the W5500 gives up
+
 class EthernetClient : public Client {
 
 public:
@@ -41,6 +43,9 @@ public:
   virtual void setNoDelayedACK(bool ack = false);
   // get the state of 'no Delayed ACK' option
   virtual bool getNoDelayedACK();
+  // set the time connect() waits for the connection in ms, with 0 connect() returns
+  // after the SYN is sent and connected() is true when the connection is established
+  void setConnectionTimeout(uint16_t timeout = CLIENT_WAIT);
 
   friend class EthernetServer;
   
@@ -49,6 +54,7 @@ public:
 private:
   static uint16_t _srcport;
   uint8_t _sock;
+  uint16_t _timeout;
 };
 
 #endif
@@ -37,7 +37,11 @@
 #include "Dns.h"
 
 /* Constructor */
-EthernetUDP::EthernetUDP() : _sock(MAX_SOCK_NUM) {}
+EthernetUDP::EthernetUDP() : _sock(MAX_SOCK_NUM), _burst(false), _burstOpen(false), _drop(false), _rxLeft(false) {}
+
+// one resolver for all UDP sockets, it needs a socket only while a lookup runs
+// and is allocated by the first lookup, so numeric hosts don't pay for it
+static DNSClient *udpDns = NULL;
 
 /* Start EthernetUDP socket, listening at local port PORT */
 uint8_t EthernetUDP::begin(uint16_t port) {
@@ -58,10 +62,25 @@ uint8_t EthernetUDP::begin(uint16_t port) {
   _port = port;
   _remaining = 0;
   socket(_sock, SnMR::UDP, _port, 0);
+  enableInterrupt();
 
   return 1;
 }
 
+/* Unmask the interrupts of the socket if the INTn pin is used */
+void EthernetUDP::enableInterrupt()
+{
+  _rxLeft = false;
+  if (!Ethernet.interruptMode())
+    return;
+
+  // sendUDP() waits for SEND_OK or TIMEOUT, the chip sets them only when they are unmasked
+  w5500.writeSnIMR(_sock, SnIR::RECV | SnIR::SEND_OK | SnIR::TIMEOUT);
+  w5500.writeSnIR(_sock, SnIR::RECV);
+  w5500.writeSIMR(w5500.readSIMR() | (1 << _sock));
+  Ethernet._intSockets |= (1 << _sock); // there could be data before the mask was set
+}
+
 /* Start EthernetUDP socket, listening at local port PORT */
 uint8_t EthernetUDP::beginMulticast(IPAddress ip, uint16_t port)
 {
@@ -92,6 +111,7 @@ uint8_t EthernetUDP::beginMulticast(IPAddress ip, uint16_t port)
   
   _remaining = 0;
   socket(_sock, SnMR::UDP, port, SnMR::MULTI);
+  enableInterrupt();
   return 1;
 }
 
@@ -107,6 +127,11 @@ void EthernetUDP::stop()
   if (_sock == MAX_SOCK_NUM)
     return;
 
+  if (Ethernet.interruptMode()) {
+    w5500.writeSIMR(w5500.readSIMR() & ~(1 << _sock));
+    Ethernet.clearSocketInterrupt(_sock);
+  }
+
   close(_sock);
 
   EthernetClass::_server_port[_sock] = 0;
@@ -117,26 +142,67 @@ int EthernetUDP::beginPacket(const char *host, uint16_t port)
 {
   // Look up the host first
   int ret = 0;
-  DNSClient dns;
   IPAddress remote_addr;
 
-  dns.begin(Ethernet.dnsServerIP());
-  ret = dns.getHostByName(host, remote_addr);
+  // a numeric host doesn't touch the cache and its statistics
+  if (DNSClient::inet_aton(host, remote_addr) || DNSClient::cacheLookup(host, remote_addr)) {
+    return beginPacket(remote_addr, port);
+  }
+
+  if (!udpDns) udpDns = new DNSClient();
+  if (udpDns) {
+    // the server may have changed with a new DHCP lease
+    if (!udpDns->busy()) udpDns->begin(Ethernet.dnsServerIP());
+    ret = udpDns->resolve(host, remote_addr);
+  }
   if (ret == 1) {
     return beginPacket(remote_addr, port);
-  } else {
-    return ret;
   }
+  // the expired address is used while the lookup runs or fails,
+  // so a packet is only lost when the name was never resolved
+  if (DNSClient::cacheStale(host, remote_addr)) {
+    return beginPacket(remote_addr, port);
+  }
+  _drop = true;
+  return ret == 0 ? UDP_DNS_PENDING : ret;
 }
 
 int EthernetUDP::beginPacket(IPAddress ip, uint16_t port)
 {
   _offset = 0;
-  return startUDP(_sock, rawIPAddress(ip), port);
+  _drop = false;
+  if (_burstOpen)
+  {
+    // a packet was started but never finished, close the bus
+    w5500.end_burst();
+    _burstOpen = false;
+  }
+  int ret = startUDP(_sock, rawIPAddress(ip), port);
+  if (ret && _burst)
+  {
+    W5500Class::SnStatus status;
+    w5500.readSnStatus(_sock, &status);
+    _txPtr = status.txWrite;
+    _txFree = status.txFree;
+    w5500.begin_tx_burst(_sock, _txPtr);
+    _burstOpen = true;
+  }
+  return ret;
 }
 
 int EthernetUDP::endPacket()
 {
+  if (_drop)
+  {
+    _drop = false;
+    return 0;
+  }
+  if (_burstOpen)
+  {
+    w5500.end_burst();
+    _burstOpen = false;
+    w5500.writeSnTX_WR(_sock, _txPtr + _offset);
+  }
   return sendUDP(_sock);
 }
 
@@ -147,6 +213,16 @@ size_t EthernetUDP::write(uint8_t byte)
 
 size_t EthernetUDP::write(const uint8_t *buffer, size_t size)
 {
+  if (_drop)
+    return 0;
+  if (_burstOpen)
+  {
+    if (size > (size_t)(_txFree - _offset))
+      size = _txFree - _offset;
+    w5500.burst_data(buffer, size);
+    _offset += size;
+    return size;
+  }
   uint16_t bytes_written = bufferData(_sock, _offset, buffer, size);
   _offset += bytes_written;
   return bytes_written;
@@ -157,25 +233,51 @@ int EthernetUDP::parsePacket()
   // discard any remaining bytes in the last packet
   flush();
 
-  if (w5500.getRXReceivedSize(_sock) > 0)
+  if (Ethernet.interruptMode())
   {
-    //HACK - hand-parse the UDP packet using TCP recv method
-    uint8_t tmpBuf[8];
-    int ret =0; 
-    //read 8 header bytes and get IP and port from it
-    ret = recv(_sock,tmpBuf,8);
-    if (ret > 0)
+    // nothing has arrived since the last empty poll, no need to ask the chip
+    if (!Ethernet.socketInterrupt(_sock))
+      return 0;
+    // the interrupt can also come from a send, only RECV or packets left
+    // from the last poll mean there is something to read
+    if (w5500.readSnIR(_sock) & SnIR::RECV)
     {
-      _remoteIP = tmpBuf;
-      _remotePort = tmpBuf[4];
-      _remotePort = (_remotePort << 8) + tmpBuf[5];
-      _remaining = tmpBuf[6];
-      _remaining = (_remaining << 8) + tmpBuf[7];
-
-      // When we get here, any remaining bytes are the data
-      ret = _remaining;
+      // clear the chip flag before reading the size, so a packet arriving
+      // afterwards raises INTn again
+      w5500.writeSnIR(_sock, SnIR::RECV);
     }
-    return ret;
+    else if (!_rxLeft)
+    {
+      Ethernet.clearSocketInterrupt(_sock);
+      return 0;
+    }
+  }
+
+  // one burst for the received size and the read pointer
+  W5500Class::SnStatus status;
+  w5500.readSnStatus(_sock, &status);
+  if (status.rxSize < 8 && Ethernet.interruptMode())
+  {
+    _rxLeft = false;
+    Ethernet.clearSocketInterrupt(_sock);
+  }
+  if (status.rxSize >= 8)
+  {
+    //read 8 header bytes and get IP and port from it
+    uint8_t tmpBuf[8];
+    w5500.read_data(_sock, status.rxRead, tmpBuf, 8);
+    w5500.writeSnRX_RD(_sock, status.rxRead + 8);
+    w5500.execCmdSn(_sock, Sock_RECV);
+
+    _remoteIP = tmpBuf;
+    _remotePort = tmpBuf[4];
+    _remotePort = (_remotePort << 8) + tmpBuf[5];
+    _remaining = tmpBuf[6];
+    _remaining = (_remaining << 8) + tmpBuf[7];
+    _rxLeft = status.rxSize > 8 + _remaining;
+
+    // When we get here, any remaining bytes are the data
+    return _remaining;
   }
   // There aren't any packets available
   return 0;
@@ -243,14 +345,14 @@ int EthernetUDP::peek()
 
 void EthernetUDP::flush()
 {
-  // could this fail (loop endlessly) if _remaining > 0 and recv in read fails?
-  // should only occur if recv fails after telling us the data is there, lets
-  // hope the w5500 always behaves :)
+  if (!_remaining)
+    return;
 
-  while (_remaining)
-  {
-    read();
-  }
+  // skip the rest of the packet in one step, moving the read pointer
+  // instead of reading it byte by byte over SPI
+  w5500.writeSnRX_RD(_sock, w5500.readSnRX_RD(_sock) + _remaining);
+  w5500.execCmdSn(_sock, Sock_RECV);
+  _remaining = 0;
 }
 
 void EthernetUDP::remoteIP(uint8_t *ip) {
@@ -291,3 +393,10 @@ bool EthernetUDP::getUnicastBlock() {
   return bitRead(value, 4);
 }
 
+void EthernetUDP::setBurstWrite(bool burst) {
+  _burst = burst;
+}
+
+bool EthernetUDP::getBurstWrite() {
+  return _burst;
+}
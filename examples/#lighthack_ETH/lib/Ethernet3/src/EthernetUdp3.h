@@ -46,6 +46,8 @@
 #include <Udp.h>
 
 #define UDP_TX_PACKET_MAX_SIZE 24
+// beginPacket(host, port) without a known address, the packet is dropped
+#define UDP_DNS_PENDING 0 // the name is being resolved, the packet can be sent again later
 
 class EthernetUDP : public UDP {
 private:
@@ -55,6 +57,14 @@ private:
   uint16_t _remotePort; // remote port for the incoming packet whilst it's being processed
   uint16_t _offset; // offset into the packet being sent
   uint16_t _remaining; // remaining bytes of incoming packet yet to be processed
+  bool _burst; // write the packet with one SPI burst
+  bool _burstOpen; // a burst is running between beginPacket and endPacket
+  uint16_t _txPtr; // Tx write pointer at beginPacket, used in burst mode
+  uint16_t _txFree; // free Tx buffer at beginPacket, used in burst mode
+  bool _drop; // the hostname of the packet is not resolved yet, discard it
+  bool _rxLeft; // more packets are in the Rx buffer, used with the INTn pin
+
+  void enableInterrupt(); // unmask the socket interrupts when the INTn pin is used
 
 public:
   EthernetUDP();  // Constructor
@@ -68,7 +78,9 @@ public:
   // Returns 1 if successful, 0 if there was a problem with the supplied IP address or port
   virtual int beginPacket(IPAddress ip, uint16_t port);
   // Start building up a packet to send to the remote host specific in host and port
-  // Returns 1 if successful, 0 if there was a problem resolving the hostname or port
+  // The hostname is taken from a cache or resolved in the background, an expired
+  // address is used until the new answer arrives. Only a name which was never resolved
+  // discards the packet, then UDP_DNS_PENDING or a DNS error (DNS_TIMED_OUT ...) is returned
   virtual int beginPacket(const char *host, uint16_t port);
   // Finish off this packet and send it
   // Returns 1 if the packet was sent successfully, 0 if there was an error
@@ -110,6 +122,8 @@ public:
   virtual bool getBroadcastBlock(); // get Broadcast blocking state
   virtual void setUnicastBlock(bool block = false); // set Unicast blocking, only  when socketin Multicast mode
   virtual bool getUnicastBlock();  // get Unicast blocking state  
+  void setBurstWrite(bool burst = false); // write packets with one SPI burst, no other SPI access allowed between beginPacket and endPacket
+  bool getBurstWrite(); // get Burst write state
   
 };
 
@@ -358,9 +358,10 @@ uint16_t igmpsend(SOCKET s, const uint8_t * buf, uint16_t len)
 uint16_t bufferData(SOCKET s, uint16_t offset, const uint8_t* buf, uint16_t len)
 {
   uint16_t ret =0;
-  if (len > w5500.getTXFreeSize(s))
+  uint16_t freesize = w5500.getTXFreeSize(s); // one stable read for the check and the size
+  if (len > freesize)
   {
-    ret = w5500.getTXFreeSize(s); // check size not to exceed MAX size.
+    ret = freesize; // check size not to exceed MAX size.
   }
   else
   {
@@ -382,8 +383,12 @@ int startUDP(SOCKET s, uint8_t* addr, uint16_t port)
   }
   else
   {
-    w5500.writeSnDIPR(s, addr);
-    w5500.writeSnDPORT(s, port);
+    // Sn_DIPR and Sn_DPORT are adjacent, write both with one burst
+    uint8_t dest[6];
+    memcpy(dest, addr, 4);
+    dest[4] = port >> 8;
+    dest[5] = port & 0xFF;
+    w5500.writeSnDEST(s, dest);
     return 1;
   }
 }
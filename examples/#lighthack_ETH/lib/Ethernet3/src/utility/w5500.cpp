@@ -21,18 +21,100 @@
 W5500Class w5500;
 
 // SPI details
-SPISettings wiznet_SPI_settings(8000000, MSBFIRST, SPI_MODE0);
+SPISettings wiznet_SPI_settings(W5500_SPI_CLOCK, MSBFIRST, SPI_MODE0);
 uint8_t SPI_CS;
+static bool spiStarted = false;
 
-void W5500Class::init(uint8_t socketNumbers, uint8_t ss_pin)
+#if defined(W5500_SPI_DMA) && defined(SPI_HAS_TRANSFER_ASYNC)
+#include <EventResponder.h>
+static EventResponder spiEvent;
+static volatile bool spiDone;
+
+static void spiEventHandler(EventResponderRef event) {
+  spiDone = true;
+}
+
+// DMA transfer, the CPU only waits for the end of the block
+static void spiTransferDMA(const uint8_t *tx, uint8_t *rx, uint16_t len) {
+  static bool attached = false;
+  if (!attached) {
+    spiEvent.attachImmediate(&spiEventHandler);
+    attached = true;
+  }
+  spiDone = false;
+  SPI.transfer(tx, rx, len, spiEvent);
+  while (!spiDone);
+}
+#endif
+
+// block transfers, the byte loop is only used if the SPI library has no
+// transfer for const buffers
+static inline void spiWriteBlock(const uint8_t *buf, uint16_t len)
+{
+#if defined(W5500_SPI_DMA) && defined(SPI_HAS_TRANSFER_ASYNC)
+  if (len >= W5500_DMA_THRESHOLD) {
+    spiTransferDMA(buf, NULL, len);
+    return;
+  }
+#endif
+#if defined(KINETISK) || defined(KINETISL) || defined(__IMXRT1062__)
+  SPI.transfer(buf, NULL, len);
+#elif defined(ESP32)
+  SPI.writeBytes(buf, len);
+#else
+  for (uint16_t i=0; i<len; i++){
+    SPI.transfer(buf[i]);
+  }
+#endif
+}
+
+static inline void spiReadBlock(uint8_t *buf, uint16_t len)
+{
+#if defined(W5500_SPI_DMA) && defined(SPI_HAS_TRANSFER_ASYNC)
+  if (len >= W5500_DMA_THRESHOLD) {
+    spiTransferDMA(NULL, buf, len);
+    return;
+  }
+#endif
+  memset(buf, 0, len);
+  SPI.transfer(buf, len);
+}
+
+void W5500Class::setSpiClock(uint32_t clock)
+{
+  wiznet_SPI_settings = SPISettings(clock, MSBFIRST, SPI_MODE0);
+}
+
+// buffer sizes in KB for every socket, valid are 0, 1, 2, 4, 8, 16 and the sum must not exceed 16
+static bool validBufferSizes(const uint8_t *sizes)
+{
+  uint8_t sum = 0;
+  for (int i = 0; i < MAX_SOCK_NUM; i++) {
+    if (sizes[i] > 16 || (sizes[i] & (sizes[i] - 1))) return false;
+    sum += sizes[i];
+  }
+  return sum <= 16;
+}
+
+void W5500Class::init(uint8_t socketNumbers, uint8_t ss_pin, const uint8_t *rxSizes, const uint8_t *txSizes)
 {
   SPI_CS = ss_pin;
 
-  delay(1000);
   initSS();
   SPI.begin();
+  spiStarted = true;
+  // no fixed power-up delay, go on as soon as the chip answers
+  waitReady(1000);
+
+  if(rxSizes && txSizes && validBufferSizes(rxSizes) && validBufferSizes(txSizes)) {
+    for (int i = 0; i < MAX_SOCK_NUM; i++) {
+      uint8_t cntl_byte = (0x0C + (i<<5));
+      write( 0x1E, cntl_byte, rxSizes[i]); //0x1E - Sn_RXBUF_SIZE
+      write( 0x1F, cntl_byte, txSizes[i]); //0x1F - Sn_TXBUF_SIZE
+    }
+  }
 
-  if(socketNumbers == 1) {
+  else if(socketNumbers == 1) {
     for (int i = 1; i < MAX_SOCK_NUM; i++) {
       uint8_t cntl_byte = (0x0C + (i<<5));
       write( 0x1E, cntl_byte, 0); //0x1E - Sn_RXBUF_SIZE
@@ -78,13 +160,23 @@ void W5500Class::init(uint8_t socketNumbers, uint8_t ss_pin)
   }
 }
 
+#if defined(W5500_SPI_STATS)
+uint32_t W5500Class::spiTransactions = 0;
+uint32_t W5500Class::spiBytes = 0;
+  #define SPI_STATS(len) do { spiTransactions++; spiBytes += 3 + (len); } while (0)
+#else
+  #define SPI_STATS(len)
+#endif
+
+// Sn_TX_FSR and Sn_RX_RSR can change between the two bytes of a read, also
+// within a burst, so the datasheet asks to read them until two reads agree.
+// The last read of the loop is the first of the next compare.
 uint16_t W5500Class::getTXFreeSize(SOCKET s)
 {
-    uint16_t val=0, val1=0;
+    uint16_t val = readSnTX_FSR(s), val1;
     do {
-        val1 = readSnTX_FSR(s);
-        if (val1 != 0)
-            val = readSnTX_FSR(s);
+        val1 = val;
+        val = readSnTX_FSR(s);
     }
     while (val != val1);
     return val;
@@ -92,16 +184,35 @@ uint16_t W5500Class::getTXFreeSize(SOCKET s)
 
 uint16_t W5500Class::getRXReceivedSize(SOCKET s)
 {
-    uint16_t val=0,val1=0;
+    uint16_t val = readSnRX_RSR(s), val1;
     do {
-        val1 = readSnRX_RSR(s);
-        if (val1 != 0)
-            val = readSnRX_RSR(s);
+        val1 = val;
+        val = readSnRX_RSR(s);
     }
     while (val != val1);
     return val;
 }
 
+void W5500Class::readSnStatus(SOCKET s, SnStatus *status)
+{
+    uint8_t buf[12];
+    uint16_t txFree, rxSize;
+    readSn(s, 0x0020, buf, 12);
+    do {
+        // the sizes are confirmed like getTXFreeSize(), the pointers come with the last burst
+        txFree = (buf[0] << 8) | buf[1];
+        rxSize = (buf[6] << 8) | buf[7];
+        readSn(s, 0x0020, buf, 12);
+    }
+    while (txFree != ((buf[0] << 8) | buf[1]) || rxSize != ((buf[6] << 8) | buf[7]));
+    status->txFree  = txFree;
+    status->txRead  = (buf[2] << 8) | buf[3];
+    status->txWrite = (buf[4] << 8) | buf[5];
+    status->rxSize  = rxSize;
+    status->rxRead  = (buf[8] << 8) | buf[9];
+    status->rxWrite = (buf[10] << 8) | buf[11];
+}
+
 void W5500Class::send_data_processing(SOCKET s, const uint8_t *data, uint16_t len)
 {
   // This is same as having no offset in a call to send_data_processing_offset
@@ -138,8 +249,33 @@ void W5500Class::read_data(SOCKET s, volatile uint16_t src, volatile uint8_t *ds
     read((uint16_t)src , cntl_byte, (uint8_t *)dst, len);
 }
 
+void W5500Class::begin_tx_burst(SOCKET s, uint16_t ptr)
+{
+    SPI_STATS(0);
+    SPI.beginTransaction(wiznet_SPI_settings);
+    setSS();
+    SPI.transfer(ptr >> 8);
+    SPI.transfer(ptr & 0xFF);
+    SPI.transfer(0x14+(s<<5));
+}
+
+void W5500Class::burst_data(const uint8_t *data, uint16_t len)
+{
+#if defined(W5500_SPI_STATS)
+    spiBytes += len;
+#endif
+    spiWriteBlock(data, len);
+}
+
+void W5500Class::end_burst()
+{
+    resetSS();
+    SPI.endTransaction();
+}
+
 uint8_t W5500Class::write(uint16_t _addr, uint8_t _cb, uint8_t _data)
 {
+    SPI_STATS(1);
     SPI.beginTransaction(wiznet_SPI_settings);
     setSS();
     SPI.transfer(_addr >> 8);
@@ -154,14 +290,13 @@ uint8_t W5500Class::write(uint16_t _addr, uint8_t _cb, uint8_t _data)
 
 uint16_t W5500Class::write(uint16_t _addr, uint8_t _cb, const uint8_t *_buf, uint16_t _len)
 {
+    SPI_STATS(_len);
     SPI.beginTransaction(wiznet_SPI_settings);
     setSS();
     SPI.transfer(_addr >> 8);
     SPI.transfer(_addr & 0xFF);
     SPI.transfer(_cb);
-    for (uint16_t i=0; i<_len; i++){
-        SPI.transfer(_buf[i]);
-    }
+    spiWriteBlock(_buf, _len);
     resetSS();
     SPI.endTransaction();
 
@@ -170,6 +305,7 @@ uint16_t W5500Class::write(uint16_t _addr, uint8_t _cb, const uint8_t *_buf, uin
 
 uint8_t W5500Class::read(uint16_t _addr, uint8_t _cb)
 {
+    SPI_STATS(1);
     SPI.beginTransaction(wiznet_SPI_settings);
     setSS();
     SPI.transfer(_addr >> 8);
@@ -184,14 +320,13 @@ uint8_t W5500Class::read(uint16_t _addr, uint8_t _cb)
 
 uint16_t W5500Class::read(uint16_t _addr, uint8_t _cb, uint8_t *_buf, uint16_t _len)
 {
+    SPI_STATS(_len);
     SPI.beginTransaction(wiznet_SPI_settings);
     setSS();
     SPI.transfer(_addr >> 8);
     SPI.transfer(_addr & 0xFF);
     SPI.transfer(_cb);
-    for (uint16_t i=0; i<_len; i++){
-        _buf[i] = SPI.transfer(0);
-    }
+    spiReadBlock(_buf, _len);
     resetSS();
     SPI.endTransaction();
 
@@ -209,6 +344,7 @@ void W5500Class::execCmdSn(SOCKET s, SockCMD _cmd) {
 
 uint8_t W5500Class::readVersion(void)
 {
+    SPI_STATS(1);
     SPI.beginTransaction(wiznet_SPI_settings);
     setSS();
     SPI.transfer( 0x00 );
@@ -221,6 +357,21 @@ uint8_t W5500Class::readVersion(void)
     return _data;
 }
 
+bool W5500Class::waitReady(uint16_t timeout)
+{
+    if (!spiStarted) {
+        // no SPI before init, the only choice is to wait
+        delay(timeout);
+        return true;
+    }
+    unsigned long start = millis();
+    while (readVersion() != 0x04) {
+        if ((millis() - start) >= timeout) return false;
+        delay(1);
+    }
+    return true;
+}
+
 // Soft reset the Wiznet chip, by writing to its MR register reset bit
 uint8_t W5500Class::softReset(void)
 {
@@ -16,6 +16,20 @@
 
 #define MAX_SOCK_NUM 8
 
+// SPI clock of the W5500, 8MHz works with the wiring of most breakout boards,
+// the chip is guaranteed up to 33.3MHz, higher clocks are opt-in with short wires,
+// e.g. -DW5500_SPI_CLOCK=30000000 for Teensy 3.x, 4.x or 12000000 for SAMD, STM32, ESP32,
+// AVR boards are limited to F_CPU / 2 by the hardware
+#ifndef W5500_SPI_CLOCK
+  #define W5500_SPI_CLOCK 8000000
+#endif
+
+// with -DW5500_SPI_DMA blocks with at least this size are transferred with DMA,
+// only for boards with an asynchronous SPI transfer like Teensy 3.x, 4.x
+#ifndef W5500_DMA_THRESHOLD
+  #define W5500_DMA_THRESHOLD 64
+#endif
+
 
 #include <Arduino.h>
 #include <SPI.h>
@@ -131,9 +145,12 @@ public:
 class W5500Class {
 
 public:
-  void init(uint8_t socketNumbers, uint8_t ss_pin = 10);
+  void init(uint8_t socketNumbers, uint8_t ss_pin = 10, const uint8_t *rxSizes = NULL, const uint8_t *txSizes = NULL);
   static uint8_t softReset(void);
+  static void setSpiClock(uint32_t clock = W5500_SPI_CLOCK);
   uint8_t readVersion(void);
+  // polls the version register until the chip answers, returns false on timeout
+  bool waitReady(uint16_t timeout = 1000);
 
   /**
    * @brief	This function is being used for copy the data form Receive buffer of the chip to application buffer.
@@ -173,6 +190,17 @@ public:
    */
   void recv_data_processing(SOCKET s, uint8_t *data, uint16_t len, uint8_t peek = 0);
 
+  /**
+   * @brief Open a write burst into the Tx buffer of a socket at the given pointer.
+   *
+   * The data is clocked in with burst_data() and the burst is closed with end_burst().
+   * No other SPI access is allowed until the burst is closed, so a datagram
+   * built from many small writes needs only one SPI transaction for its payload.
+   */
+  void begin_tx_burst(SOCKET s, uint16_t ptr);
+  void burst_data(const uint8_t *data, uint16_t len);
+  void end_burst();
+
   inline void setGatewayIp(uint8_t *_addr);
   inline void getGatewayIp(uint8_t *_addr);
 
@@ -198,6 +226,34 @@ public:
   uint16_t getTXFreeSize(SOCKET s);
   uint16_t getRXReceivedSize(SOCKET s);
 
+  /**
+   * @brief Socket buffer status block, Sn_TX_FSR up to Sn_RX_WR
+   */
+  struct SnStatus {
+    uint16_t txFree;  // Sn_TX_FSR
+    uint16_t txRead;  // Sn_TX_RD
+    uint16_t txWrite; // Sn_TX_WR
+    uint16_t rxSize;  // Sn_RX_RSR
+    uint16_t rxRead;  // Sn_RX_RD
+    uint16_t rxWrite; // Sn_RX_WR
+  };
+
+  /**
+   * @brief Read the complete buffer status block of a socket with one SPI burst.
+   *
+   * The registers 0x0020 ... 0x002B are adjacent, so all pointers and sizes
+   * are fetched in one transaction instead of twelve byte accesses, the burst
+   * is repeated until the sizes of two bursts agree.
+   */
+  void readSnStatus(SOCKET s, SnStatus *status);
+
+#if defined(W5500_SPI_STATS)
+  // SPI bus statistics, enabled with -DW5500_SPI_STATS
+  static uint32_t spiTransactions; // number of CS cycles
+  static uint32_t spiBytes; // bytes clocked including the 3 byte header
+  static void resetSpiStats() { spiTransactions = 0; spiBytes = 0; }
+#endif
+
 
   // W5500 Registers
   // ---------------
@@ -216,13 +272,15 @@ private:
   }
 #define __GP_REGISTER16(name, address)            \
   static void write##name(uint16_t _data) {       \
-    write(address,  0x04, _data >> 8);            \
-    write(address+1, 0x04, _data & 0xFF);         \
+    uint8_t buf[2];                               \
+    buf[0] = _data >> 8;                          \
+    buf[1] = _data & 0xFF;                        \
+    write(address, 0x04, buf, 2);                 \
   }                                               \
   static uint16_t read##name() {                  \
-    uint16_t res = read(address, 0x00);           \
-    res = (res << 8) + read(address + 1, 0x00);   \
-    return res;                                   \
+    uint8_t buf[2];                               \
+    read(address, 0x00, buf, 2);                  \
+    return (buf[0] << 8) | buf[1];                \
   }
 #define __GP_REGISTER_N(name, address, size)      \
   static uint16_t write##name(uint8_t *_buff) {   \
@@ -238,8 +296,11 @@ public:
   __GP_REGISTER_N(SUBR,   0x0005, 4); // Subnet mask address
   __GP_REGISTER_N(SHAR,   0x0009, 6); // Source MAC address
   __GP_REGISTER_N(SIPR,   0x000F, 4); // Source IP address
+  __GP_REGISTER16(INTLEVEL, 0x0013);  // Interrupt Low Level Timer
   __GP_REGISTER8 (IR,     0x0015);    // Interrupt
   __GP_REGISTER8 (IMR,    0x0016);    // Interrupt Mask
+  __GP_REGISTER8 (SIR,    0x0017);    // Socket Interrupt
+  __GP_REGISTER8 (SIMR,   0x0018);    // Socket Interrupt Mask
   __GP_REGISTER16(RTR,    0x0019);    // Timeout address
   __GP_REGISTER8 (RCR,    0x001B);    // Retry count
   __GP_REGISTER_N(UIPR,   0x0028, 4); // Unreachable IP address in UDP mode
@@ -269,32 +330,20 @@ private:
   static inline uint8_t read##name(SOCKET _s) {              \
     return readSn(_s, address);                              \
   }
-#if defined(REL_GR_KURUMI) || defined(REL_GR_KURUMI_PROTOTYPE)
+// 16 bit registers are accessed with one SPI burst, so the high and low byte
+// are transferred in the same frame and need only one CS cycle
 #define __SOCKET_REGISTER16(name, address)                   \
   static void write##name(SOCKET _s, uint16_t _data) {       \
-    writeSn(_s, address,   _data >> 8);                      \
-    writeSn(_s, address+1, _data & 0xFF);                    \
+    uint8_t buf[2];                                          \
+    buf[0] = _data >> 8;                                     \
+    buf[1] = _data & 0xFF;                                   \
+    writeSn(_s, address, buf, 2);                            \
   }                                                          \
   static uint16_t read##name(SOCKET _s) {                    \
-    uint16_t res = readSn(_s, address);                      \
-    uint16_t res2 = readSn(_s,address + 1);                  \
-    res = res << 8;                                          \
-    res2 = res2 & 0xFF;                                      \
-    res = res | res2;                                        \
-    return res;                                              \
+    uint8_t buf[2];                                          \
+    readSn(_s, address, buf, 2);                             \
+    return (buf[0] << 8) | buf[1];                           \
   }
-#else
-#define __SOCKET_REGISTER16(name, address)                   \
-  static void write##name(SOCKET _s, uint16_t _data) {       \
-    writeSn(_s, address,   _data >> 8);                      \
-    writeSn(_s, address+1, _data & 0xFF);                    \
-  }                                                          \
-  static uint16_t read##name(SOCKET _s) {                    \
-    uint16_t res = readSn(_s, address);                      \
-    res = (res << 8) + readSn(_s, address + 1);              \
-    return res;                                              \
-  }
-#endif
 #define __SOCKET_REGISTER_N(name, address, size)             \
   static uint16_t write##name(SOCKET _s, uint8_t *_buff) {   \
     return writeSn(_s, address, _buff, size);                \
@@ -312,6 +361,7 @@ public:
   __SOCKET_REGISTER_N(SnDHAR,     0x0006, 6)     // Destination Hardw Addr
   __SOCKET_REGISTER_N(SnDIPR,     0x000C, 4)     // Destination IP Addr
   __SOCKET_REGISTER16(SnDPORT,    0x0010)        // Destination Port
+  __SOCKET_REGISTER_N(SnDEST,     0x000C, 6)     // Destination IP Addr and Port in one burst
   __SOCKET_REGISTER16(SnMSSR,     0x0012)        // Max Segment Size
   __SOCKET_REGISTER8(SnPROTO,     0x0014)        // Protocol in IP RAW Mode
   __SOCKET_REGISTER8(SnTOS,       0x0015)        // IP TOS
@@ -324,6 +374,7 @@ public:
   __SOCKET_REGISTER16(SnRX_RSR,   0x0026)        // RX Free Size
   __SOCKET_REGISTER16(SnRX_RD,    0x0028)        // RX Read Pointer
   __SOCKET_REGISTER16(SnRX_WR,    0x002A)        // RX Write Pointer (supported?)
+  __SOCKET_REGISTER8(SnIMR,       0x002C)        // Interrupt Mask
 
 #undef __SOCKET_REGISTER8
 #undef __SOCKET_REGISTER16
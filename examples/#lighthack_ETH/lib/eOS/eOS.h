@@ -39,7 +39,9 @@ put 100nF ceramic capitors between ground and the input of the buttons
 
 #include "Arduino.h"
 #include "OSCMessage.h"
+#include "OSCBundle.h"
 #include "Udp.h"
+#include "Client.h"
 
 #define SUBSCRIBE		1
 #define UNSUBSCRIBE	0
@@ -56,7 +58,131 @@ put 100nF ceramic capitors between ground and the input of the buttons
 #define FADER_UPDATE_RATE_MS	40 // update each 40ms
 #define THRESHOLD		4 // Jitter threshold of the faders
 
-enum interface_t {EOSUSB, EOSUDP};
+#define EOS_VERSION		"1.2.0" // version of the library, sent with the status
+
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__) || defined(__AVR_ATmega32U4__)
+	#define EOS_RX_SMALL // boards with 2 - 2.5KB RAM, e.g. UNO, Nano, Leonardo
+#endif
+#ifndef EOS_RX_SLOTS
+	#ifdef EOS_RX_SMALL
+		#define EOS_RX_SLOTS		2
+	#else
+		#define EOS_RX_SLOTS		4 // number of packets the receive ring can hold
+	#endif
+#endif
+#ifndef EOS_RX_SLOT_SIZE
+	#ifdef EOS_RX_SMALL
+		#define EOS_RX_SLOT_SIZE	96
+	#else
+		#define EOS_RX_SLOT_SIZE	128 // max size of a received packet, larger packets are dropped
+	#endif
+#endif
+
+#ifndef EOS_LINK_QUEUE
+	#define EOS_LINK_QUEUE		8 // number of button edges kept while the link is down
+#endif
+#define EOS_LINK_CHECK_MS	50 // interval of the link check
+#ifndef EOS_PING_AFTER_MS
+	#define EOS_PING_AFTER_MS	2500 // idle time before a ping is sent to see if EOS is still there
+#endif
+#ifndef EOS_TIMEOUT_MS
+	#define EOS_TIMEOUT_MS		5000 // idle time before the connection is lost
+#endif
+#ifndef EOS_DESTINATIONS
+	#define EOS_DESTINATIONS	2 // number of consoles, e.g. primary and backup, max 8
+#endif
+#ifndef EOS_TX_SIZE
+	#define EOS_TX_SIZE				128 // buffer for a message which is encoded once for all consoles
+#endif
+#define EOS_DISCOVERY_MS	1000 // interval of the discovery probes
+#ifndef EOS_EEPROM_ADDR
+	#define EOS_EEPROM_ADDR		0 // EEPROM address of the cached console, it needs 10 bytes
+#endif
+#if !defined(EOS_EEPROM) && (defined(__AVR__) || defined(TEENSYDUINO) || defined(ESP8266) || defined(ESP32))
+	#define EOS_EEPROM // boards with EEPROM or EEPROM emulation
+#endif
+
+#ifndef EOS_TCP_TX_SIZE
+	#define EOS_TCP_TX_SIZE			256 // buffer to coalesce the messages into TCP segments
+#endif
+#ifndef EOS_TCP_COALESCE_MS
+	#define EOS_TCP_COALESCE_MS	2 // latency cap of the coalescing, 0 sends each message at once
+#endif
+#define EOS_TCP_RETRY_MS		1000 // interval of the connection attempts
+
+#ifndef EOS_TRANSPORTS
+	#define EOS_TRANSPORTS			2 // number of further transports, e.g. UDP as backup for USB
+#endif
+#define EOS_ANY							0xFF // no fixed transport, the policy decides
+
+#ifndef EOS_CAPTURE
+	#define EOS_CAPTURE					0 // bytes of the capture ring, 0 leaves the capture out
+#endif
+#ifndef EOS_CAPTURE_CHUNK
+	#define EOS_CAPTURE_CHUNK		512 // max size of a datagram of a capture dump over UDP
+#endif
+#define EOS_CAPTURE_TX				0x80 // flag of a sent packet in a capture record
+
+#ifndef EOS_PROFILE
+	#define EOS_PROFILE					0 // 1 measures the loop and the stages, 0 leaves the profiler out
+#endif
+#define EOS_PROFILE_BINS			10 // loop time histogram, < 64us, < 128us ... >= 16ms
+#ifndef EOS_LATENCY
+	#define EOS_LATENCY					0 // 1 measures the time from an input to the send, 0 leaves it out
+#endif
+#define EOS_LATENCY_BINS			12 // latency histogram, < 16us, < 32us ... >= 16ms
+#ifndef EOS_RAM_SIZE
+	#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega168__)
+		#define EOS_RAM_SIZE				2048 // RAM of the board for the budget checks, UNO, Nano
+	#elif defined(__AVR_ATmega32U4__)
+		#define EOS_RAM_SIZE				2560 // Leonardo, Micro
+	#elif defined(__AVR_ATmega2560__)
+		#define EOS_RAM_SIZE				8192 // Mega
+	#elif defined(__MKL26Z64__)
+		#define EOS_RAM_SIZE				8192 // Teensy LC
+	#elif defined(__MK20DX256__)
+		#define EOS_RAM_SIZE				65536 // Teensy 3.2
+	#elif defined(__MK64FX512__) || defined(__MK66FX1M0__)
+		#define EOS_RAM_SIZE				262144 // Teensy 3.5, 3.6
+	#elif defined(__IMXRT1062__)
+		#define EOS_RAM_SIZE				524288 // Teensy 4.x, RAM1 with the variables and the stack
+	#elif defined(__SAMD51__)
+		#define EOS_RAM_SIZE				196608 // SAMD51, e.g. Metro M4
+	#elif defined(ARDUINO_ARCH_SAMD)
+		#define EOS_RAM_SIZE				32768 // SAMD21, e.g. Zero, MKR
+	#elif defined(__SAM3X8E__)
+		#define EOS_RAM_SIZE				98304 // Due
+	#elif defined(ESP8266)
+		#define EOS_RAM_SIZE				81920 // RAM for the sketch
+	#elif defined(ESP32)
+		#define EOS_RAM_SIZE				327680 // DRAM
+	#else
+		#define EOS_RAM_SIZE				0 // not checked, e.g. STM32 with its many variants
+	#endif
+#endif
+#ifndef EOS_RAM_BUDGET
+	#define EOS_RAM_BUDGET			(EOS_RAM_SIZE / 2) // max RAM of an EOS object with its buffers, the rest is for the sketch
+#endif
+#ifndef EOS_RAM_CONTROL
+	#define EOS_RAM_CONTROL			(EOS_RAM_SIZE / 16) // max RAM of one control with the heap of its Strings
+#endif
+#define EOS_STRING_HEAP				16 // heap of a short String, up to 13 characters, the terminator and the header of malloc
+
+enum interface_t {EOSUSB, EOSUDP, EOSTCP};
+enum framing_t {TCP_LENGTH, TCP_SLIP}; // OSC 1.0 packet length, OSC 1.1 SLIP
+enum policy_t {FAILOVER, MIRROR};
+
+class EOSCapture;
+
+/**
+ * @brief a button edge of a control which is kept while the link is down, the message is built again for the reconnect
+ * 
+ */
+struct LinkEdge {
+	void (*message)(const void *control, uint8_t value, OSCMessage &msg); // builds the message into an OSCMessage(), empty() clears its error
+	const void *control;
+	uint8_t value; // EDGE_DOWN or EDGE_UP
+	};
 
 /**
  * @brief Class definitions for a general interface
@@ -76,6 +202,16 @@ class EOS {
 		 */
 		EOS(UDP &udp, IPAddress ip, uint16_t port, interface_t interface = EOSUDP);
 
+		/**
+		 * @brief Construct a new EOS object for Ethernet communication over tcp
+		 * 
+		 * @param client TCP client instance
+		 * @param ip console IP
+		 * @param port console port, EOS uses 3032 for TCP_LENGTH and 3037 for TCP_SLIP
+		 * @param framing TCP_LENGTH (OSC 1.0) or TCP_SLIP (OSC 1.1)
+		 */
+		EOS(Client &client, IPAddress ip, uint16_t port, framing_t framing = TCP_SLIP);
+
 		/**
 		 * @brief Construct a new EOS object for Serial communication
 		 * 
@@ -87,8 +223,8 @@ class EOS {
 		 * @brief send OSC message
 		 * 
 		 * @param msg OSC message
-		 * @param ip optional destination IP address
-		 * @param port optional destination port
+		 * @param ip optional destination IP address, only for UDP
+		 * @param port optional destination port, only for UDP
 		 */
 		void sendOSC(OSCMessage& msg, IPAddress ip, uint16_t port);
 
@@ -99,13 +235,466 @@ class EOS {
 		 */
 		void sendOSC(OSCMessage& msg);
 
+		/**
+		 * @brief send OSC message over a fixed transport
+		 * 
+		 * @param msg OSC message
+		 * @param transport index of the transport, 0 is this one, EOS_ANY uses the policy
+		 */
+		void sendOSC(OSCMessage& msg, uint8_t transport);
+
+		/**
+		 * @brief receive all pending packets into the receive ring,
+		 * then call the handler for every message in order of arrival
+		 * 
+		 * @param handler function which is called for every received OSC message, can be NULL
+		 * @return uint8_t number of handled messages
+		 */
+		uint8_t receive(void (*handler)(OSCMessage& msg));
+
+		/**
+		 * @brief get the maximum number of ring slots used by one receive call
+		 * 
+		 * @return uint8_t high-water mark of the receive ring
+		 */
+		uint8_t rxHighWater();
+
+		/**
+		 * @brief get the number of dropped packets, because the ring was full or the packet too large
+		 * 
+		 * @return uint16_t dropped packets
+		 */
+		uint16_t rxDropped();
+
+		/**
+		 * @brief get the traffic counters, without framing, over TCP a packet is one message
+		 * 
+		 * @return uint32_t sent or received packets or bytes
+		 */
+		uint32_t txPackets();
+		uint32_t txBytes();
+		uint32_t rxPackets();
+		uint32_t rxBytes();
+
+		/**
+		 * @brief get the loop rate, measured each second by update()
+		 * 
+		 * @return uint32_t calls of update() per second
+		 */
+		uint32_t loopRate();
+
+		/**
+		 * @brief set the firmware version of the box, it is sent with the status
+		 * 
+		 * @param version e.g. "2.1", the string must stay valid
+		 */
+		void firmware(const char *version);
+
+		/**
+		 * @brief send the status bundle of the box periodically, it is also the answer to the OSC message /eos-box/status
+		 * 
+		 * @param interval in ms, 0 stops it
+		 * @param ip optional receiver, e.g. a dashboard, only for EOSUDP, without it the console
+		 * @param port of the receiver
+		 */
+		void statusPublish(uint32_t interval);
+		void statusPublish(uint32_t interval, IPAddress ip, uint16_t port);
+
+		/**
+		 * @brief capture all sent and received packets with a timestamp into a ring of EOS_CAPTURE bytes,
+		 * the oldest packets are dropped when it is full, does nothing without the build flag EOS_CAPTURE
+		 * 
+		 * @param on true starts the capture, false stops it and keeps the ring
+		 */
+		void capture(bool on = true);
+
+		/**
+		 * @brief get the state of the capture
+		 * 
+		 * @return true while the packets are captured
+		 */
+		bool capturing();
+
+		/**
+		 * @brief get the size of the captured packets
+		 * 
+		 * @return uint32_t bytes in the ring, the records included
+		 */
+		uint32_t captureSize();
+
+		/**
+		 * @brief get the number of captured packets which were dropped for newer ones
+		 * 
+		 * @return uint16_t dropped packets
+		 */
+		uint16_t captureDropped();
+
+		/**
+		 * @brief clear the capture ring
+		 * 
+		 */
+		void captureClear();
+
+		/**
+		 * @brief write the capture as a file, e.g. to Serial of an Ethernet box or to a SD card,
+		 * not to the Serial which is used by EOSUSB
+		 * 
+		 * @param out Print object
+		 */
+		void captureDump(Print &out);
+
+		/**
+		 * @brief send the capture as datagrams of whole records, without the file header
+		 * 
+		 * @param udp UDP object, e.g. the one of the box
+		 * @param ip of the receiver
+		 * @param port of the receiver
+		 */
+		void captureDump(UDP &udp, IPAddress ip, uint16_t port);
+
+		/**
+		 * @brief collect all following messages in one OSC bundle instead of sending them,
+		 * e.g. the filters and subscriptions of the init
+		 * 
+		 */
+		void beginBundle();
+
+		/**
+		 * @brief send the collected messages as one packet
+		 * 
+		 */
+		void endBundle();
+
+		/**
+		 * @brief set a hook which is called once with the time since power-on,
+		 * when the first message after the init bundle is sent, e.g. a fader move
+		 * 
+		 * @param hook function with the boot time in milliseconds
+		 */
+		void bootHook(void (*hook)(uint32_t bootTime));
+
+		/**
+		 * @brief get the boot time, it is also sent with the status
+		 * 
+		 * @return uint32_t ms from power-on to the first message after the init bundle, 0 until then
+		 */
+		uint32_t bootTime();
+
+		/**
+		 * @brief set a function which gives back the state of the link, e.g. the PHY link of the W5500,
+		 * it is checked every EOS_LINK_CHECK_MS by update()
+		 * 
+		 * @param check function which returns true when the link is up
+		 */
+		void linkCheck(bool (*check)());
+
+		/**
+		 * @brief set a function which sends the filters, subscriptions and fader config,
+		 * it is called inside a bundle each time the link comes up
+		 * 
+		 * @param init function with the init messages
+		 */
+		void initHook(void (*init)());
+
+		/**
+		 * @brief check the link and replay the init and the buffered button edges when it returns,
+		 * must be in the loop
+		 * 
+		 */
+		void update();
+
+		/**
+		 * @brief send the init bundle again, e.g. after the console was restarted
+		 * 
+		 */
+		void reinit();
+
+		/**
+		 * @brief get the state of the link, always true without a link check
+		 * 
+		 * @return true if the link is up
+		 */
+		bool link();
+
+		/**
+		 * @brief get the time from the loss of the link until init and buffered edges were sent again
+		 * 
+		 * @return uint32_t time of the last reconnect in milliseconds
+		 */
+		uint32_t reconnectTime();
+
+		/**
+		 * @brief get the number of messages dropped while the link was down,
+		 * continuous values like faders are always dropped, button edges when the buffer is full
+		 * 
+		 * @return uint16_t dropped messages
+		 */
+		uint16_t linkDropped();
+
+		/**
+		 * @brief set the name which is sent with the pings of the connection manager,
+		 * the filter "/eos/out/ping" is needed to get the answers
+		 * 
+		 * @param message ping name, e.g. "box1_hello"
+		 */
+		void pingMessage(String message);
+
+		/**
+		 * @brief get the state of the connection, the handshake or any received message connects,
+		 * no message for EOS_TIMEOUT_MS disconnects
+		 * 
+		 * @return true if EOS, or one of the consoles, is connected
+		 */
+		bool connected();
+
+		/**
+		 * @brief get the round-trip times of the pings
+		 * 
+		 * @param index of the console
+		 * @return uint32_t minimum, average and maximum in microseconds, 0 before the first answer
+		 */
+		uint32_t rttMin(uint8_t index = 0);
+		uint32_t rttAvg(uint8_t index = 0);
+		uint32_t rttMax(uint8_t index = 0);
+
+		/**
+		 * @brief get the number of sent and of lost pings, a ping is lost without an answer in EOS_TIMEOUT_MS
+		 * 
+		 * @param index of the console
+		 * @return uint16_t number of pings
+		 */
+		uint16_t pingsSent(uint8_t index = 0);
+		uint16_t pingsLost(uint8_t index = 0);
+
+		/**
+		 * @brief get the loss rate of the pings
+		 * 
+		 * @param index of the console
+		 * @return uint8_t lost pings in percent
+		 */
+		uint8_t pingLoss(uint8_t index = 0);
+
+		/**
+		 * @brief add a further console, e.g. a backup, only for EOSUDP,
+		 * each message is encoded once and sent to all consoles which are not dead
+		 * 
+		 * @param ip destination IP
+		 * @param port destination port
+		 * @return true if there was a free slot (EOS_DESTINATIONS)
+		 */
+		bool addDestination(IPAddress ip, uint16_t port);
+
+		/**
+		 * @brief get the number of consoles
+		 * 
+		 * @return uint8_t number of destinations
+		 */
+		uint8_t destinations();
+
+		/**
+		 * @brief get the console whose messages go to the receive handler,
+		 * the first connected one in the order the consoles were added
+		 * 
+		 * @return uint8_t index of the console, 0 is the one of the constructor
+		 */
+		uint8_t active();
+
+		/**
+		 * @brief get the state of the connection to one console,
+		 * a console which lost a ping is dead and gets only pings until it answers again
+		 * 
+		 * @param index of the console
+		 * @return true if the console is connected
+		 */
+		bool connected(uint8_t index);
+
+		/**
+		 * @brief find the console without a fixed IP, only for EOSUDP,
+		 * a ping is broadcast every EOS_DISCOVERY_MS and the first console which answers is used,
+		 * it is cached in the EEPROM, so the next boot connects at once to the cached console
+		 * and only looks again when it doesn't answer
+		 * 
+		 * @param port OSC UDP RX port of the console
+		 */
+		void discover(uint16_t port = 8000);
+
+		/**
+		 * @brief get the state of the discovery
+		 * 
+		 * @return true while the console is searched
+		 */
+		bool discovering();
+
+		/**
+		 * @brief get the IP of the first console, e.g. found by the discovery
+		 * 
+		 * @return IPAddress of the console
+		 */
+		IPAddress consoleIP();
+
+		/**
+		 * @brief clear the cached console in the EEPROM
+		 * 
+		 */
+		void forget();
+
+		/**
+		 * @brief add a further transport at the same time, e.g. UDP as backup for USB,
+		 * it is an own EOS object which is updated and received by this one
+		 * 
+		 * @param transport EOS object of the transport
+		 * @return uint8_t index of the transport, 0 if there is no free slot (EOS_TRANSPORTS)
+		 */
+		uint8_t addTransport(EOS &transport);
+
+		/**
+		 * @brief set how the messages are sent with further transports
+		 * 
+		 * @param policy FAILOVER uses the first healthy transport, MIRROR sends over all
+		 */
+		void policy(policy_t policy);
+
+		/**
+		 * @brief get the transport which is used by FAILOVER,
+		 * the first one with a link and a connection in the order they were added
+		 * 
+		 * @return uint8_t index of the transport, 0 is this one
+		 */
+		uint8_t transport();
+
 	private:
 
+		enum discovery_t {DISCOVERY_OFF, DISCOVERY_CACHED, DISCOVERY_SEARCH};
+
+		struct Destination {
+			IPAddress ip;
+			uint16_t port;
+			bool connected;
+			bool wasLost; // the connection timed out, the console may need the init again
+			bool dead; // the last ping was lost, normal messages are skipped
+			bool pingPending;
+			int32_t pingSeq; // sequence number of the pending ping
+			uint32_t rxTime; // millis() of the last received packet
+			uint32_t pingTime; // millis() of the last ping
+			uint32_t pingMicros; // micros() of the last ping for the round-trip time
+			uint16_t pingCount;
+			uint16_t pingLost;
+			uint16_t rttCount;
+			uint32_t rttLow;
+			uint32_t rttHigh;
+			uint32_t rttSum;
+			};
+
+		// the state of the features below is allocated when a feature is used, so a box without them doesn't pay for it
+
+		struct TcpState { // allocated by the TCP constructor
+			uint8_t tx[EOS_TCP_TX_SIZE]; // coalescing buffer
+			uint16_t fill;
+			uint32_t time; // millis() of the first message in the buffer
+			uint32_t retry; // millis() of the last connection attempt
+			framing_t framing;
+			bool escape; // SLIP escape in the stream
+			uint8_t header; // received bytes of the packet length
+			uint32_t length; // missing bytes of the packet
+			};
+
+		struct Reconnect { // allocated by linkCheck(), discover() and the TCP constructor
+			uint32_t linkCheckTime;
+			uint32_t linkLostTime; // 0 until the link was up once
+			uint32_t reconnectMs;
+			uint16_t linkDrops;
+			LinkEdge linkQueue[EOS_LINK_QUEUE]; // button edges while the console can't be reached
+			uint8_t linkQueued;
+			uint16_t discoveryPort;
+			uint32_t probeTime;
+			};
+
+		struct Publish { // allocated by statusPublish()
+			uint32_t interval;
+			uint32_t time;
+			IPAddress ip;
+			uint16_t port;
+			};
+
 		UDP *udp;
+		Client *client;
 		HardwareSerial *s;
-		IPAddress ip;
-		uint16_t port;
 		interface_t interface;
+		Destination console; // the first console
+		Destination *dests; // the console, with addDestination() an array of EOS_DESTINATIONS on the heap
+		uint8_t destCount;
+		uint8_t *txBuffer; // allocated with the second console
+		uint8_t rxRing[EOS_RX_SLOTS][EOS_RX_SLOT_SIZE];
+		uint16_t rxSize[EOS_RX_SLOTS];
+		uint8_t rxFrom[EOS_RX_SLOTS]; // index of the console which sent the packet
+		uint8_t rxHead;
+		uint8_t rxCount;
+		uint8_t rxHigh;
+		uint16_t rxDrops;
+		uint16_t rxFill; // bytes of the SLIP packet in progress
+		bool rxOverflow; // the SLIP packet in progress doesn't fit
+		OSCBundle *bundle; // messages are collected while not NULL
+		void (*bootTimeHook)(uint32_t bootTime);
+		bool bootPending; // the init bundle was sent, waiting for the first control message
+		uint32_t bootMs;
+		void sendPacket(OSCMessage& msg, IPAddress ip, uint16_t port);
+		void sendPacket(OSCBundle& bundle, IPAddress ip, uint16_t port);
+		template <typename T> void sendAll(T& packet, uint8_t mask);
+		void initSend(uint8_t mask);
+		void runInit(uint8_t mask);
+		void sendLocal(OSCMessage& msg);
+		EOS **transports; // allocated by addTransport()
+		uint8_t transportCount;
+		policy_t transportPolicy;
+		bool reachable(uint8_t index);
+		bool (*linkState)();
+		void (*initFunction)();
+		bool linkUp;
+		Reconnect *reconnect;
+		Reconnect &reconnectState();
+		void initState();
+		static void initDestination(Destination &dest);
+		String pingName;
+		int32_t pingSeq;
+		discovery_t discovery;
+		void search();
+		void probeReply(uint8_t *packet, uint16_t size);
+		void replayQueue();
+		void connectionUpdate();
+		void sendPing(Destination& dest);
+		bool pingEcho(OSCMessage& msg, Destination& dest);
+		void handshake();
+		TcpState *tcp;
+		bool tcpUp; // always true for USB and UDP
+		template <typename T> void tcpSend(T& packet);
+		void tcpFlush();
+		void tcpUpdate();
+		void rxPacketUDP();
+		void rxPacketSLIP();
+		void rxPacketTCP();
+		void rxStore(uint8_t c);
+		void rxFrame();
+		void rxCommit(uint16_t size, uint8_t from);
+		EOSCapture *captureRing; // allocated by capture()
+		bool captureOn;
+		template <typename T> void captureTx(T& packet, IPAddress ip);
+		bool boxQuery(uint8_t *packet, uint16_t size);
+		void boxReply(OSCMessage& msg);
+		uint32_t txPacketCount;
+		uint32_t txByteCount;
+		uint32_t rxPacketCount;
+		uint32_t rxByteCount;
+		uint32_t loopCount;
+		uint32_t loopsPerSecond;
+		uint32_t rateTime; // millis() of the last loop rate
+		uint32_t uptime; // s, also after the overflow of millis()
+		const char *firmwareVersion;
+		Publish *publish;
+		Print *replyOut; // the status bundle in progress, NULL over TCP
+		void sendStatus(IPAddress ip, uint16_t port);
+		void replyBegin(IPAddress ip, uint16_t port);
+		void replyAdd(OSCMessage& msg);
+		void replyEnd();
 
 	};
 
@@ -119,59 +708,194 @@ class EOS {
 /**
  * @brief Filter for messages you want receive
  * 
- * 
+ * @param target optional EOS object, without it the global eos
  * @param message you want receive
  */
 void filter(String pattern);
+void filter(EOS &target, String pattern);
 
 /**
  * @brief Subscribe a parameter you want receive
  * 
+ * @param target optional EOS object, without it the global eos
  * @param parameter  for subscription
  */
 void subscribe(String parameter);
+void subscribe(EOS &target, String parameter);
 
 /**
  * @brief Unsubscribe a parameter
  * 
+ * @param target optional EOS object, without it the global eos
  * @param parameter for unsubscription
  */
 void unSubscribe(String parameter);
+void unSubscribe(EOS &target, String parameter);
 
 
 /**
  * @brief send a ping without a message
  * 
+ * @param target optional EOS object, without it the global eos
  */
 void ping();
+void ping(EOS &target);
 
 /**
  * @brief send a ping with a meassge
  * 
+ * @param target optional EOS object, without it the global eos
  * @param message 
  */
 void ping(String message);
+void ping(EOS &target, String message);
 
 /**
  * @brief send a string to the command line
  * 
+ * @param target optional EOS object, without it the global eos
  * @param cmd command line String
  */
 void command(String cmd);
+void command(EOS &target, String cmd);
 
 /**
  * @brief send a new command line string
  * 
+ * @param target optional EOS object, without it the global eos
  * @param cmd command line String
  */
 void newCommand(String newCmd);
+void newCommand(EOS &target, String newCmd);
 
 /**
  * @brief set the user
  * 
+ * @param target optional EOS object, without it the global eos
  * @param userID user
  */
 void user(int16_t userID);
+void user(EOS &target, int16_t userID);
+
+/**
+ * @brief stages of the profiler, a stage includes the stages which it calls,
+ * e.g. a Key includes the send of its message
+ * 
+ */
+enum profile_t {
+	PROFILE_UPDATE, PROFILE_RECEIVE, PROFILE_PARSE, PROFILE_SEND,
+	PROFILE_ENCODER, PROFILE_WHEEL, PROFILE_KEY, PROFILE_SUBMASTER, PROFILE_FADER, PROFILE_MACRO, PROFILE_OSCBUTTON,
+	PROFILE_DISPLAY, PROFILE_USER, PROFILE_STAGES
+	};
+
+/**
+ * @brief measure a stage from the construction until the end of the scope, e.g. the refresh of a display,
+ * the library measures its own stages and the loop time between the calls of update(),
+ * without the build flag EOS_PROFILE it is empty and costs nothing
+ * 
+ */
+class Profile {
+
+	public:
+
+#if EOS_PROFILE
+		Profile(profile_t stage);
+		~Profile();
+
+	private:
+
+		profile_t stage;
+		uint32_t start;
+#else
+		Profile(profile_t stage) {}
+#endif
+
+	};
+
+/**
+ * @brief print min, average and max time of each stage and the histogram of the loop time,
+ * the stats are also sent as answer to the OSC message /eos-box/stats
+ * 
+ * @param out Print object, e.g. Serial of an Ethernet box
+ */
+void profileReport(Print &out);
+
+/**
+ * @brief clear the stats of the profiler, also done by the OSC message /eos-box/stats/reset
+ * 
+ */
+void profileReset();
+
+/**
+ * @brief control classes of the latency histogram
+ * 
+ */
+enum latency_t {
+	LATENCY_ENCODER, LATENCY_WHEEL, LATENCY_KEY, LATENCY_SUBMASTER, LATENCY_FADER, LATENCY_MACRO, LATENCY_OSCBUTTON,
+	LATENCY_CLASSES
+	};
+
+/**
+ * @brief print the histogram of the time from the input edge to the send of the packet for each control class,
+ * needs the build flag EOS_LATENCY, it is also sent as answer to the OSC message /eos-box/latency
+ * 
+ * @param out Print object, e.g. Serial of an Ethernet box
+ */
+void latencyReport(Print &out);
+
+/**
+ * @brief clear the latency histograms, also done by the OSC message /eos-box/latency/reset
+ * 
+ */
+void latencyReset();
+
+/**
+ * @brief get the free RAM between the heap and the stack plus the free blocks of the heap
+ * 
+ * @return uint32_t bytes, 0 if it isn't known for the board
+ */
+uint32_t freeRam();
+
+/**
+ * @brief get the fragmentation of the heap, 0 means the free RAM is one block
+ * 
+ * @return uint8_t percent of the free RAM which is not in the largest free block
+ */
+uint8_t heapFragmentation();
+
+/**
+ * @brief get the lowest free RAM since the start, on AVR and ARM the free RAM is painted
+ * by the first update() after setup() and the largest part which neither the heap nor the stack reached is measured,
+ * on ESP32 it is the lowest free heap, else the lowest freeRam() of the calls of update()
+ * 
+ * @return uint32_t bytes, 0 if it isn't known for the board
+ */
+uint32_t ramLowWater();
+
+/**
+ * @brief print the RAM of the EOS object, each control, the buffers on the heap,
+ * the free RAM, the fragmentation and the low-water mark
+ * 
+ * @param out Print object, e.g. Serial of an Ethernet box
+ */
+void ramReport(Print &out);
+
+/**
+ * @brief take the time of the library from another clock, e.g. the virtual clock of a simulation or a test,
+ * all times are compared wrap-safe, so the clock can overflow like millis()
+ * 
+ * @param ms function which gives back the time in ms, NULL is millis()
+ * @param us optional function which gives back the time in us, without it micros() or the us counted from the steps of ms
+ */
+void clockSource(uint32_t (*ms)(), uint32_t (*us)() = NULL);
+
+/**
+ * @brief get the time of the clock of the library, for timeouts of the sketch which should follow a simulation
+ * 
+ * @return uint32_t ms or us
+ */
+uint32_t clockMillis();
+uint32_t clockMicros();
 
 
 /**
@@ -233,8 +957,23 @@ class Encoder {
 		 * 
 		 */
 		void update();
+
+		/**
+		 * @brief send to another EOS object than the global eos, for a second console or a media server
+		 * 
+		 * @param target EOS object
+		 */
+		void bind(EOS &target);
+
+		/**
+		 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+		 * 
+		 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+		 */
+		void transport(uint8_t index);
 	
 	private:
+		static void homeMessage(const void *encoder, uint8_t value, OSCMessage &msg);
 		String param;
 		uint8_t pinA;
 		uint8_t pinB;
@@ -245,6 +984,8 @@ class Encoder {
 		uint8_t buttonPinLast;
 		uint8_t direction;
 		int8_t encoderMotion;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
@@ -292,6 +1033,20 @@ class Wheel {
 		 * 
 		 */
 		void update();
+
+		/**
+		 * @brief send to another EOS object than the global eos, for a second console or a media server
+		 * 
+		 * @param target EOS object
+		 */
+		void bind(EOS &target);
+
+		/**
+		 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+		 * 
+		 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+		 */
+		void transport(uint8_t index);
 	
 	private:
 		uint8_t idx;
@@ -304,6 +1059,8 @@ class Wheel {
 		uint8_t buttonMode;
 		uint8_t direction;
 		int8_t encoderMotion;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
@@ -329,11 +1086,28 @@ class Key {
 		 */
 		void update();
 
+		/**
+		 * @brief send to another EOS object than the global eos, for a second console or a media server
+		 * 
+		 * @param target EOS object
+		 */
+		void bind(EOS &target);
+
+		/**
+		 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+		 * 
+		 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+		 */
+		void transport(uint8_t index);
+
 	private:
 
+		static void edgeMessage(const void *key, uint8_t value, OSCMessage &msg);
 		String keyPattern;
   	uint8_t pin;
   	uint8_t last;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
@@ -360,25 +1134,44 @@ class Submaster {
 		 */
 		void update();
 
+		/**
+		 * @brief send to another EOS object than the global eos, for a second console or a media server
+		 * 
+		 * @param target EOS object
+		 */
+		void bind(EOS &target);
+
+		/**
+		 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+		 * 
+		 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+		 */
+		void transport(uint8_t index);
+
 	private:
 
+		static void fireMessage(const void *sub, uint8_t value, OSCMessage &msg);
 		String subPattern;
 		uint8_t analogPin;
 		uint8_t firePin;
 		int16_t analogLast;
 		uint8_t fireLast;
 		uint32_t updateTime;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
 /**
  * @brief initialise a fader bank
  * 
+ * @param target optional EOS object, without it the global eos
  * @param page fader page of the console, standard is 1
  * @param faders number of faders, standard is 10
  * @param bank number of the OSC fader bank, standard is 1
  */
 void initFaders(uint8_t page = 1, uint8_t faders = 10, uint8_t bank = 1);
+void initFaders(EOS &target, uint8_t page = 1, uint8_t faders = 10, uint8_t bank = 1);
 
 /**
  * @brief Fader object with stop and fire buttons
@@ -405,6 +1198,20 @@ class Fader {
 	 */
 	void update();
 
+	/**
+	 * @brief send to another EOS object than the global eos, for a second console or a media server
+	 * 
+	 * @param target EOS object
+	 */
+	void bind(EOS &target);
+
+	/**
+	 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+	 * 
+	 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+	 */
+	void transport(uint8_t index);
+
 	/**
 	 * @brief set the OSC fader bank of the fader object
 	 * 
@@ -435,6 +1242,8 @@ class Fader {
 
 	private:
 
+		static void fireMessage(const void *fader, uint8_t value, OSCMessage &msg);
+		static void stopMessage(const void *fader, uint8_t value, OSCMessage &msg);
 		String faderPattern;
 		uint8_t bank; 
 		uint8_t fader;
@@ -445,6 +1254,8 @@ class Fader {
   	uint8_t fireLast;
   	uint8_t stopLast;
 		uint32_t updateTime;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
@@ -470,11 +1281,28 @@ class Macro {
 	 */
 	void update();
 
+	/**
+	 * @brief send to another EOS object than the global eos, for a second console or a media server
+	 * 
+	 * @param target EOS object
+	 */
+	void bind(EOS &target);
+
+	/**
+	 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+	 * 
+	 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+	 */
+	void transport(uint8_t index);
+
 	private:
 
+		static void fireMessage(const void *macro, uint8_t value, OSCMessage &msg);
 		String firePattern;
 		uint8_t pin;
     uint8_t last;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
@@ -535,19 +1363,64 @@ class OscButton {
 	 */
 	void update();
 
+	/**
+	 * @brief send to another EOS object than the global eos, for a second console or a media server
+	 * 
+	 * @param target EOS object
+	 */
+	void bind(EOS &target);
+
+	/**
+	 * @brief send over a fixed transport and not by the policy, see EOS::addTransport()
+	 * 
+	 * @param index of the transport, 0 is the EOS object, EOS_ANY uses the policy
+	 */
+	void transport(uint8_t index);
+
 	private:
 
 		enum osc_t {NONE, INT32, FLOAT32, STRING};
+		static void pressMessage(const void *button, uint8_t value, OSCMessage &msg);
 		osc_t typ;
 		String pattern;
 		int32_t integer32;
 		float float32;
 		String message;
 		IPAddress ip;
-		uint16_t port;
+		uint16_t port = 0; // 0 sends to the console of eos
 		uint8_t pin;
     uint8_t last;
+		uint8_t transportIndex = EOS_ANY;
+		EOS *target = NULL; // NULL is the global eos
 
 	};
 
-#endif
\ No newline at end of file
+/**
+ * @brief RAM of the EOS object and of each control at compile time, with the heap of their Strings,
+ * checked against EOS_RAM_BUDGET and EOS_RAM_CONTROL of the board, see ramReport() for the values
+ * 
+ */
+#define EOS_RAM_EOS						(sizeof(EOS) + EOS_CAPTURE)
+#define EOS_RAM_ENCODER				(sizeof(Encoder) + EOS_STRING_HEAP)
+#define EOS_RAM_WHEEL					sizeof(Wheel)
+#define EOS_RAM_KEY						(sizeof(Key) + EOS_STRING_HEAP)
+#define EOS_RAM_SUBMASTER			(sizeof(Submaster) + EOS_STRING_HEAP)
+#define EOS_RAM_FADER					(sizeof(Fader) + EOS_STRING_HEAP)
+#define EOS_RAM_MACRO					(sizeof(Macro) + EOS_STRING_HEAP)
+#define EOS_RAM_OSCBUTTON			(sizeof(OscButton) + 2 * EOS_STRING_HEAP)
+
+#ifndef EOS_RAM_TABLE_BUDGET
+	#define EOS_RAM_TABLE_BUDGET	(EOS_RAM_SIZE * 3 / 4) // max RAM of the EOS object with the tables of a sketch
+#endif
+
+/**
+ * @brief stop the build when a table of the sketch with the EOS object doesn't fit into EOS_RAM_TABLE_BUDGET,
+ * strings is the number of Strings in each entry of the table, e.g. EOS_ASSERT_TABLE(parameter, 2);
+ * 
+ */
+#define EOS_ASSERT_TABLE(table, strings) \
+	static_assert(!EOS_RAM_SIZE || EOS_RAM_EOS + sizeof(table) \
+		+ (sizeof(table) / sizeof((table)[0])) * (strings) * EOS_STRING_HEAP <= EOS_RAM_TABLE_BUDGET, \
+		"the table " #table " needs more RAM than EOS_RAM_TABLE_BUDGET, reduce its size")
+
+#endif
@@ -67,26 +67,20 @@ THE SOFTWARE.
 #define ENCODERS				2 // number of encoders you use
 #define PARAMETER_MAX		26 // 14 for UNO, number of parameters must even
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "box_x_eth_hello";
 const String PARAMETER_QUERY = "/eos/out/param/";
 
 // See displayScreen() below - limited to 10 chars (after 6 prefix chars)
 const String VERSION_STRING = "2.0.0.0";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
 // Definition of the parameter you want to use
 const String NO_PARAMETER = "none"; // none is a keyword used when there is no parameter
 int8_t idx = 0; // start with parameter index 2 must even
 
 // Network config
+// with AUTO_CONFIG the box gets its IP by DHCP and looks for the console,
+// the console found is kept in the EEPROM, localIP and eosIP are not used then
+//#define AUTO_CONFIG
 uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48};
 IPAddress localIP(10, 101, 1, 201);
 IPAddress subnet(255, 255, 0, 0);
@@ -97,8 +91,6 @@ uint16_t eosPort = 8000;
 // Global variables
 bool updateDisplay = false;
 bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
 
 // special chars
 uint8_t upArrow[8] = {  
@@ -180,6 +172,9 @@ struct Parameter parameter[PARAMETER_MAX] = {
 	{"Angle D"},
 	};
 
+// the names are on the heap, reduce PARAMETER_MAX when the build stops here
+EOS_ASSERT_TABLE(parameter, 2);
+
 // Hardware constructors
 EthernetUDP udp;
 EOS eos(udp, eosIP, eosPort);
@@ -212,8 +207,8 @@ void splashScreen() {
 	}
 
 /**
- * @brief Init the console, gives back a handshake reply
- * and send the filters and subscribtions.
+ * @brief Init the console, send the filters and subscribtions,
+ * eOS sends them as one bundle when the link comes up.
  *
  */
 void initEOS() {
@@ -225,6 +220,15 @@ void initEOS() {
 	subscribe(parameter[idx + 1].name);
 	}
 
+/**
+ * @brief Link state of the W5500 PHY, checked by eos.update()
+ *
+ * @return true if the link is up
+ */
+bool ethernetLink() {
+	return Ethernet.link();
+	}
+
 /**
  * @brief This helper first unsubribe all parameters and subscribe the new ones
  * 
@@ -279,7 +283,6 @@ void activeCueUpdate(OSCMessage& msg, int addressOffset) {
 	char text[msg.getDataLength(0)];
 	msg.getString(0, text);
 	parseCueMessage(&activeCue, text);
-	connectedToEos = true;
 	updateDisplay = true; 
 	}
 
@@ -293,44 +296,31 @@ void pendingCueUpdate(OSCMessage& msg, int addressOffset) {
 	char text[msg.getDataLength(0)];
 	msg.getString(0, text);
 	parseCueMessage(&pendingCue, text);
-	connectedToEos = true;
 	updateDisplay = true;
 	}
 
 /**
  * @brief 
- * Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue a subscribe, otherwise we begin route the OSC
- * message to the appropriate function.
+ * Given an OSC message we update the parameters values,
+ * or route it to the appropriate function.
  * 
  * @param msg - the OSC message of unknown importance
  *
  */
-void parseOSCMessage(String& msg) {
-	// Prepare the message for routing by filling an OSCMessage object with our message string
-	static String parseMsg;
-	OSCMessage oscmsg;
-	oscmsg.fill((uint8_t*)msg.c_str(), (int)msg.length());
-	parseMsg = PARAMETER_QUERY + parameter[idx].name;
-	if (msg.indexOf(parseMsg) != -1) {
-		parameter[idx].value = oscmsg.getFloat(0);
-		connectedToEos = true;
+void parseOSCMessage(OSCMessage& msg) {
+	if (msg.fullMatch((PARAMETER_QUERY + parameter[idx].name).c_str())) {
+		parameter[idx].value = msg.getFloat(0);
 		updateDisplay = true;
-		parseMsg = String();
 		return;
 		}
-	parseMsg = String();
-	parseMsg = PARAMETER_QUERY + parameter[idx + 1].name;
-	if (msg.indexOf(parseMsg) != -1) {
-		parameter[idx + 1].value = oscmsg.getFloat(0);
-		connectedToEos = true;
+	if (msg.fullMatch((PARAMETER_QUERY + parameter[idx + 1].name).c_str())) {
+		parameter[idx + 1].value = msg.getFloat(0);
 		updateDisplay = true;
-		parseMsg = String();
 		return;
 		}
 	// Route cue messages to the relevant update function
-	oscmsg.route("/eos/out/active/cue/text", activeCueUpdate);
-	oscmsg.route("/eos/out/pending/cue/text", pendingCueUpdate);
+	msg.route("/eos/out/active/cue/text", activeCueUpdate);
+	msg.route("/eos/out/pending/cue/text", pendingCueUpdate);
 	}
 
 /**
@@ -442,18 +432,29 @@ void displayStatus() {
  * 
  */
 void setup() {
+	// Ethernet init first, the PHY negotiates the link while the LCD and the controls are set up
+	#ifdef AUTO_CONFIG
+		Ethernet.beginAsync(mac); // DHCP in the background
+	#else
+		Ethernet.begin(mac, localIP, subnet);
+	#endif
+	while(!udp.begin(localPort));
+	udp.setBurstWrite(true); // one SPI burst for each OSC message
+	eos.linkCheck(ethernetLink);
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS); // sent each time the link comes up
+	#ifdef AUTO_CONFIG
+		eos.discover(eosPort); // the cached console or the first one which answers
+	#endif
+
 	// LCD init
 	lcd.createChar(0, upArrow);
 	lcd.createChar(1, downArrow);
 	lcd.begin(LCD_CHARS, LCD_LINES);
 	lcd.clear();
 	splashScreen();
-	// Ethernet init
-	Ethernet.begin(mac, localIP, subnet);
-  while(!udp.begin(localPort));
-	
-	// eOS init
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+
+	// eOS init, filters and subscriptions are sent by eos.update() when the link is up
 	shiftButton(SHIFT_BTN);
 	encoder1.button(ENC_1_BTN);
 	encoder2.button(ENC_2_BTN);
@@ -475,9 +476,9 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
+	#ifdef AUTO_CONFIG
+		Ethernet.maintain();
+	#endif
 	// Check for hardware updates
 	updateControlButton(&parameterUp);
 	updateControlButton(&parameterDown);
@@ -488,35 +489,13 @@ void loop() {
 	encoder2.update();
 
 	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = udp.parsePacket();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(udp.read());
-		//}
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			updateDisplay = true;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;	
-			}
+	// and update the display accordingly, the handshake, the pings
+	// and the timeout are handled by eOS
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		updateDisplay = true;
 		}
 	if (updateDisplay) displayStatus();
 	}
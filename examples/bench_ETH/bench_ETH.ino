@@ -0,0 +1,141 @@
+/*
+Copyright (c) 2020 Stefan Staub
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+// Compares the UDP and the TCP transport of eOS, run it against a console
+// or the stand-in of extras/standin, which prints the received packets per second.
+// The time for sending a burst of wheel messages and the round-trip time
+// of the pings are printed to the serial monitor.
+
+// libraries included
+
+#include "Arduino.h"
+#include <OSCMessage.h>
+#include "eOS.h"
+#include "Ethernet3.h"
+#include "EthernetUdp3.h"
+
+// Transport, comment out for UDP
+#define USE_TCP
+#define FRAMING					TCP_SLIP // or TCP_LENGTH
+
+#define BURST						100 // messages for each measurement
+#define BURST_INTERVAL	2000 // time between two measurements in ms
+
+// Network config
+uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48};
+IPAddress localIP(10, 101, 1, 201);
+IPAddress subnet(255, 255, 0, 0);
+IPAddress eosIP(10, 101, 1, 100);
+uint16_t localPort = 8001;
+
+// Hardware constructors
+#ifdef USE_TCP
+	EthernetClient tcp;
+	EOS eos(tcp, eosIP, FRAMING == TCP_SLIP ? 3037 : 3032, FRAMING);
+#else
+	EthernetUDP udp;
+	EOS eos(udp, eosIP, 8000);
+#endif
+
+uint32_t burstTime;
+
+// Local functions
+
+/**
+ * @brief give back the state of the PHY link for the link check of eOS
+ *
+ * @return true if the link is up
+ */
+bool ethernetLink() {
+	return Ethernet.link();
+	}
+
+/**
+ * @brief Init the console, only the ping answers are needed
+ *
+ */
+void initEOS() {
+	filter("/eos/out/ping");
+	}
+
+/**
+ * @brief send a burst of wheel messages and print the time,
+ * the coalescing of TCP puts several messages in one segment
+ *
+ */
+void burst() {
+	uint32_t start = micros();
+	for (uint16_t i = 0; i < BURST; i++) {
+		OSCMessage wheel("/eos/wheel/coarse/pan");
+		wheel.add(i & 1 ? 1.0 : -1.0);
+		eos.sendOSC(wheel);
+		eos.update(); // the TCP buffer is sent after EOS_TCP_COALESCE_MS
+		}
+	uint32_t time = micros() - start;
+	Serial.print(BURST);
+	Serial.print(" messages in ");
+	Serial.print(time);
+	Serial.print("us, ");
+	Serial.print(time / BURST);
+	Serial.print("us each, rtt ");
+	Serial.print(eos.rttMin());
+	Serial.print("/");
+	Serial.print(eos.rttAvg());
+	Serial.print("/");
+	Serial.print(eos.rttMax());
+	Serial.print("us, ping loss ");
+	Serial.print(eos.pingLoss());
+	Serial.println("%");
+	}
+
+/**
+ * @brief setup the Ethernet and the transport
+ *
+ */
+void setup() {
+	Serial.begin(115200);
+	Ethernet.begin(mac, localIP, subnet);
+	#ifdef USE_TCP
+		tcp.setConnectionTimeout(0); // eos.update() connects without blocking the loop
+		Serial.println("eOS benchmark TCP");
+	#else
+		udp.begin(localPort);
+		Serial.println("eOS benchmark UDP");
+	#endif
+	eos.linkCheck(ethernetLink);
+	eos.pingMessage("bench_hello");
+	eos.initHook(initEOS);
+	burstTime = millis();
+	}
+
+/**
+ * @brief a burst of messages every BURST_INTERVAL while connected
+ *
+ */
+void loop() {
+	eos.update();
+	eos.receive(NULL);
+	if (eos.connected() && millis() - burstTime >= BURST_INTERVAL) {
+		burstTime = millis();
+		burst();
+		}
+	}
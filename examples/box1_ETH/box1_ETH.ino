@@ -56,26 +56,20 @@ THE SOFTWARE.
 
 #define SIG_DIGITS		3 // Number of significant digits displayed
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "box1_eth_hello";
 const String PARAMETER_QUERY = "/eos/out/param/";
 
 // See displayScreen() below - limited to 10 chars (after 6 prefix chars)
 const String VERSION_STRING = "1.0.0.0";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
 // Definition of the parameter you want to use
 const String ENCODER_1_PARAMETER = "Pan";
 const String ENCODER_2_PARAMETER = "Tilt";
 
 // Network config
+// with AUTO_CONFIG the box gets its IP by DHCP and looks for the console,
+// the console found is kept in the EEPROM, localIP and eosIP are not used then
+//#define AUTO_CONFIG
 uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48};
 IPAddress localIP(10, 101, 1, 201);
 IPAddress subnet(255, 255, 0, 0);
@@ -86,8 +80,6 @@ uint16_t localPort = 8001;
 // Global variables
 bool updateDisplay = false;
 bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
 
 struct Parameter {
 	String name;
@@ -109,8 +101,8 @@ Encoder encoder2(ENC_2_A, ENC_2_B, FORWARD);
 // Local functions
 
 /**
- * @brief Init the console, gives back a handshake reply
- * and send the filters and subscribtions.
+ * @brief Init the console, send the filters and subscribtions,
+ * eOS sends them as one bundle when the link comes up.
  *
  */
 void initEOS() {
@@ -120,6 +112,15 @@ void initEOS() {
 	subscribe(ENCODER_2_PARAMETER);
 	}
 
+/**
+ * @brief Link state of the W5500 PHY, checked by eos.update()
+ *
+ * @return true if the link is up
+ */
+bool ethernetLink() {
+	return Ethernet.link();
+	}
+
 /**
  * @brief 
  * Given a valid OSCMessage (relevant to Pan/Tilt), we update our Encoder struct
@@ -140,21 +141,15 @@ void parseEnc2Update(OSCMessage& msg, int addressOffset) {
 
 /**
  * @brief 
- * Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue a subscribe, otherwise we begin route the OSC
- * message to the appropriate function.
+ * Given an OSC message we route it to the appropriate function.
  * 
  * @param msg - the OSC message of unknown importance
  *
  */
-void parseOSCMessage(String& msg) {
-	// Prepare the message for routing by filling an OSCMessage object with our message string
-	OSCMessage oscmsg;
-	oscmsg.fill((uint8_t*)msg.c_str(), (int)msg.length());
+void parseOSCMessage(OSCMessage& msg) {
 	// Route parameter messages to the relevant update function
-	oscmsg.route((PARAMETER_QUERY + ENCODER_1_PARAMETER).c_str(), parseEnc1Update);
-	oscmsg.route((PARAMETER_QUERY + ENCODER_2_PARAMETER).c_str(), parseEnc2Update);
-	connectedToEos = true;
+	msg.route((PARAMETER_QUERY + ENCODER_1_PARAMETER).c_str(), parseEnc1Update);
+	msg.route((PARAMETER_QUERY + ENCODER_2_PARAMETER).c_str(), parseEnc2Update);
 	}
 
 /**
@@ -198,13 +193,22 @@ void displayStatus() {
 void setup() {
 	Serial.begin(9600);
 	// Ethernet init
-	Ethernet.begin(mac, localIP, subnet);
+	#ifdef AUTO_CONFIG
+		Ethernet.beginAsync(mac); // DHCP in the background
+	#else
+		Ethernet.begin(mac, localIP, subnet);
+	#endif
   udp.begin(localPort);
 	// LCD init
 	lcd.begin(LCD_CHARS, LCD_LINES);
 	lcd.clear();
-	// eOS init
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+	// eOS init, filters and subscriptions are sent by eos.update() each time the link comes up
+	eos.linkCheck(ethernetLink);
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS);
+	#ifdef AUTO_CONFIG
+		eos.discover(eosPort); // the cached console or the first one which answers
+	#endif
 	shiftButton(SHIFT_BTN);
 	encoder1.parameter(ENCODER_1_PARAMETER);
 	encoder2.parameter(ENCODER_2_PARAMETER);
@@ -224,9 +228,9 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
+	#ifdef AUTO_CONFIG
+		Ethernet.maintain();
+	#endif
 	// Check for hardware updates
 	next.update();
 	last.update();
@@ -234,35 +238,13 @@ void loop() {
 	encoder2.update();
 
 	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = udp.parsePacket();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(udp.read());
-		//}
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			updateDisplay = true;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;	
-			}
+	// and update the display accordingly, the handshake, the pings
+	// and the timeout are handled by eOS
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		updateDisplay = true;
 		}
 	if (updateDisplay) displayStatus();
 	}
@@ -72,8 +72,6 @@ THE SOFTWARE.
 #define UP							0
 #define DOWN						1
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "box2b_hello";
 const String PARAMETER_QUERY = "/eos/out/param/";
 const String NO_PARAMETER = "none"; // none is a keyword used when there is no parameter
@@ -81,18 +79,9 @@ const String NO_PARAMETER = "none"; // none is a keyword used when there is no p
 // See displayScreen() below - limited to 10 chars (after 6 prefix chars)
 const String VERSION_STRING = "2.0.0.0";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
 // Global variables
 bool updateDisplay = false;
 bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
 int8_t idx = 0; // start with parameter index 2 must even
 
 /**
@@ -163,7 +152,6 @@ Key selectLast(SELECT_LAST_BTN, "SELECT_LAST");
  *
  */
 void initEOS() {
-	SLIPSerial.print(HANDSHAKE_REPLY);
 	filter("/eos/out/param/*");
 	filter("/eos/out/ping");
 	subscribe(parameter[idx].name);
@@ -208,39 +196,21 @@ void displayStatus() {
 	}
 
 /**
- * @brief Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue the init, otherwise we update the parameters values.
+ * @brief Given an OSC message we update the parameters values,
+ * the handshake is already handled by eOS.
  * 
  * @param msg - the OSC message of unknown importance
  *
  */
-void parseOSCMessage(String& msg) {
-	static String parseMsg;
-	if (msg.indexOf(HANDSHAKE_QUERY) != -1) { // Check to see if this is the handshake string
-		initEOS();
-		connectedToEos = true;
+void parseOSCMessage(OSCMessage& msg) {
+	if (msg.fullMatch((PARAMETER_QUERY + parameter[idx].name).c_str())) {
+		parameter[idx].value = msg.getFloat(0);
 		updateDisplay = true;
 		return;
 		}
-	else {
-		OSCMessage oscmsg;
-		oscmsg.fill((uint8_t*)msg.c_str(), (int)msg.length());
-		parseMsg = PARAMETER_QUERY + parameter[idx].name;
-		if (msg.indexOf(parseMsg) != -1) {
-				parameter[idx].value = oscmsg.getFloat(0);
-				connectedToEos = true;
-				updateDisplay = true;
-				parseMsg = String();
-				return;
-				}
-		parseMsg = PARAMETER_QUERY + parameter[idx + 1].name;
-		if (msg.indexOf(parseMsg) != -1) {
-			parameter[idx + 1].value = oscmsg.getFloat(0);
-			connectedToEos = true;
-			updateDisplay = true;
-			parseMsg = String();
-			return;
-			}
+	if (msg.fullMatch((PARAMETER_QUERY + parameter[idx + 1].name).c_str())) {
+		parameter[idx + 1].value = msg.getFloat(0);
+		updateDisplay = true;
 		}
 	}
 
@@ -320,7 +290,9 @@ void setup() {
 	lcd.begin(LCD_CHARS, LCD_LINES);
 	lcd.clear();
 
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS);
+	eos.reinit(); // for hotplug with Arduinos without native USB like UNO
 	shiftButton(SHIFT_BTN);
 	encoder1.button(ENC_1_BTN);
 	encoder2.button(ENC_2_BTN);
@@ -342,9 +314,6 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
 	// Check for hardware updates
 	updateControlButton(&parameterUp);
 	updateControlButton(&parameterDown);
@@ -355,36 +324,13 @@ void loop() {
 	selectLast.update();
 
 	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = SLIPSerial.available();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(SLIPSerial.read());
-		}
-	if (SLIPSerial.endofPacket()) {
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			updateDisplay = true;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;
-			}
+	// and update the display accordingly, the handshake, the pings
+	// and the timeout are handled by eOS
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		updateDisplay = true;
 		}
 	if (updateDisplay) displayStatus();
 	}
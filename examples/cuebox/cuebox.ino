@@ -58,8 +58,6 @@ Note: Updated once per second.
 #define GO_BTN				8
 #define BACK_BTN			9
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "cuebox2_hello";
 const String CUE_ACTIVE_QUERY = "/eos/out/active/cue/text";
 const String CUE_PENDING_QUERY = "/eos/out/pending/cue/text";
@@ -67,18 +65,9 @@ const String CUE_PENDING_QUERY = "/eos/out/pending/cue/text";
 // See displayScreen() below - limited to 10 chars (after 6 prefix chars)
 const String VERSION_STRING = "2.0.0.0";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
 // Global variables
 bool updateDisplay = false;
 bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
 
 struct CueData {
   String cuelist;
@@ -154,12 +143,11 @@ void parseCueMessage(struct CueData *data, String msg) {
   }
 
 /**
- * @brief Init the console, gives back a handshake reply
- * and send the filters and subscribtions.
+ * @brief Init the console, send the filters and subscribtions,
+ * eOS sends them as one bundle after the handshake.
  *
  */
 void initEOS() {
-	SLIPSerial.print(HANDSHAKE_REPLY);
 	filter("/eos/out/active/cue/text");
 	filter("/eos/out/pending/cue/text");
 	filter("/eos/out/ping");
@@ -175,7 +163,6 @@ void activeCueUpdate(OSCMessage& msg, int addressOffset) {
 	char text[msg.getDataLength(0)];
 	msg.getString(0, text);
 	parseCueMessage(&activeCue, text);
-	connectedToEos = true;
 	updateDisplay = true; 
 	}
 
@@ -189,36 +176,21 @@ void pendingCueUpdate(OSCMessage& msg, int addressOffset) {
 	char text[msg.getDataLength(0)];
 	msg.getString(0, text);
 	parseCueMessage(&pendingCue, text);
-	connectedToEos = true;
 	updateDisplay = true;
 	}
 
 /**
  * @brief 
- * Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue a subscribe, otherwise we begin route the OSC
- * message to the appropriate function.
+ * Given an OSC message we route it to the appropriate function,
+ * the handshake is already handled by eOS.
  * 
  * @param msg - the OSC message of unknown importance
  *
  */
-void parseOSCMessage(String& msg) {
-	// Check to see if this is the handshake string
-	if (msg.indexOf(HANDSHAKE_QUERY) != -1) {
-		initEOS();
-		// Make our splash screen go away
-		connectedToEos = true;
-		updateDisplay = true;
-		}
-
-	else {
-		// Prepare the message for routing by filling an OSCMessage object with our message string
-		OSCMessage oscmsg;
-		oscmsg.fill((uint8_t*)msg.c_str(), (int)msg.length());
-		// Route cue messages to the relevant update function
-		oscmsg.route("/eos/out/active/cue/text", activeCueUpdate);
-		oscmsg.route("/eos/out/pending/cue/text", pendingCueUpdate);
-		}
+void parseOSCMessage(OSCMessage& msg) {
+	// Route cue messages to the relevant update function
+	msg.route("/eos/out/active/cue/text", activeCueUpdate);
+	msg.route("/eos/out/pending/cue/text", pendingCueUpdate);
 	}
 
 /**
@@ -284,7 +256,9 @@ void setup() {
 	lcd.begin(LCD_CHARS, LCD_LINES);
 	lcd.clear();
 
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS);
+	eos.reinit(); // for hotplug with Arduinos without native USB like UNO
 
 	displayStatus();
 	}
@@ -301,44 +275,18 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
 	// Check for hardware updates
 	go.update();
 	back.update();
 
 	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = SLIPSerial.available();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(SLIPSerial.read());
-		}
-	if (SLIPSerial.endofPacket()) {
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			updateDisplay = true;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;
-			}
+	// and update the display accordingly, the handshake, the pings
+	// and the timeout are handled by eOS
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		updateDisplay = true;
 		}
 	if (updateDisplay) displayStatus();
 	}
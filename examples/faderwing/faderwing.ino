@@ -62,24 +62,8 @@ THE SOFTWARE.
 #define NUMBER_OF_FADERS	10 // size of the faders per page on EOS / Nomad
 #define FADER_BANK				1	// virtuell OSC bank
 
-const String HANDSHAKE_QUERY = "ETCOSC?";
-const String HANDSHAKE_REPLY = "OK";
 const String PING_QUERY = "faderwingX_hello";
 
-// Change these values to alter how long we wait before sending an OSC ping
-// to see if Eos is still there, and then finally how long before we
-// disconnect and show the splash screen
-// Values are in milliseconds
-#define PING_AFTER_IDLE_INTERVAL		2500
-#define TIMEOUT_AFTER_IDLE_INTERVAL	5000
-
-// Global variables
-bool connectedToEos = false;
-unsigned long lastMessageRxTime = 0;
-bool timeoutPingSent = false;
-
-
-
 // Hardware constructors
 EOS eos;
 Fader fader1(FADER_1_LEVELER, FADER_1_FIRE_BUTTON, FADER_1_STOP_BUTTON, 1, FADER_BANK);
@@ -92,38 +76,15 @@ Fader fader6(FADER_6_LEVELER, FADER_6_FIRE_BUTTON, FADER_6_STOP_BUTTON, 6, FADER
 // Local functions
 
 /**
- * @brief Init the console, gives back a handshake reply
- * and send the filters and subscribtions.
+ * @brief Init the console, send the filters and subscribtions,
+ * eOS sends them as one bundle after the handshake.
  *
  */
 void initEOS() {
-	SLIPSerial.print(HANDSHAKE_REPLY);
 	filter("/eos/out/ping");
 	initFaders(FADER_PAGE, NUMBER_OF_FADERS, FADER_BANK);
 	}
 
-/**
- * @brief 
- * Given an unknown OSC message we check to see if it's a handshake message.
- * If it's a handshake we issue a subscribe.
- * 
- * @param msg - the OSC message of unknown importance
- *
- */
-void parseOSCMessage(String& msg) {
-	// check to see if this is the handshake string
-	if (msg.indexOf(HANDSHAKE_QUERY) != -1) {
-		// handshake string found!
-		connectedToEos = true;
-		initEOS();
-		}
-
-	if (msg.indexOf(PING_QUERY) != -1) {
-		// handshake string found!
-		connectedToEos = true;
-		}
-	}
-
 /**
  * @brief 
  * Here we setup our encoder, lcd, and various input devices. We also prepare
@@ -146,7 +107,9 @@ void setup() {
 		while (!Serial);
 	#endif
 
-	initEOS(); // for hotplug with Arduinos without native USB like UNO
+	eos.pingMessage(PING_QUERY);
+	eos.initHook(initEOS);
+	eos.reinit(); // for hotplug with Arduinos without native USB like UNO
 	}
 
 /**
@@ -161,9 +124,6 @@ void setup() {
  * 
  */
 void loop() {
-	static String curMsg;
-	int size;
-
 	// Check for hardware updates
 	fader1.update();
 	fader2.update();
@@ -172,35 +132,8 @@ void loop() {
 	fader5.update();
 	fader6.update();
 
-	// Then we check to see if any OSC commands have come from Eos
-	// and update the display accordingly.
-	size = SLIPSerial.available();
-	if (size > 0) {
-		// Fill the msg with all of the available bytes
-		while (size--) curMsg += (char)(SLIPSerial.read());
-		}
-	if (SLIPSerial.endofPacket()) {
-		parseOSCMessage(curMsg);
-		lastMessageRxTime = millis();
-		// We only care about the ping if we haven't heard recently
-		// Clear flag when we get any traffic
-		timeoutPingSent = false;
-		curMsg = String();
-		}
-
-	if (lastMessageRxTime > 0) {
-		unsigned long diff = millis() - lastMessageRxTime;
-		//We first check if it's been too long and we need to time out
-		if (diff > TIMEOUT_AFTER_IDLE_INTERVAL) {
-			connectedToEos = false;
-			lastMessageRxTime = 0;
-			timeoutPingSent = false;
-			}
-		//It could be the console is sitting idle. Send a ping once to
-		// double check that it's still there, but only once after 2.5s have passed
-		if (!timeoutPingSent && diff > PING_AFTER_IDLE_INTERVAL) {
-			ping(PING_QUERY);
-			timeoutPingSent = true;
-			}
-		}
+	// Then we check to see if any OSC commands have come from Eos,
+	// the handshake, the pings and the timeout are handled by eOS
+	eos.update();
+	eos.receive(NULL);
 	}
@@ -0,0 +1,135 @@
+/*
+A box for the host build, it sends over UDP to a console or the stand-in
+on 127.0.0.1 and uses all controls of eOS, see extras/host/README.md
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <OSCMessage.h>
+#include "eOS.h"
+#include "SimUDP.h"
+
+#define ENC_1_A			2
+#define ENC_1_B			3
+#define ENC_2_A			4
+#define ENC_2_B			5
+#define WHEEL_A			6
+#define WHEEL_B			7
+#define NEXT_BTN		8
+#define LAST_BTN		9
+#define SHIFT_BTN		10
+#define GO_BTN			11
+#define MACRO_BTN		12
+#define SUB_FIRE		14
+#define FADER_FIRE	15
+#define FADER_STOP	16
+#define DUMP_BTN		17
+#define SUB_LEVEL		A0
+#define FADER_LEVEL	A1
+
+const String PING_QUERY = "hostbox_hello";
+
+IPAddress eosIP(127, 0, 0, 1);
+uint16_t eosPort = 8000;
+uint16_t localPort = 8001;
+
+SimUDP udp;
+EOS eos(udp, eosIP, eosPort);
+
+Encoder encoder1(ENC_1_A, ENC_1_B, FORWARD);
+Encoder encoder2(ENC_2_A, ENC_2_B, FORWARD);
+Wheel wheel(WHEEL_A, WHEEL_B, FORWARD);
+Key next(NEXT_BTN, "NEXT");
+Key last(LAST_BTN, "LAST");
+Key go(GO_BTN, "GO_0");
+Macro macro(MACRO_BTN, 101);
+Submaster sub(SUB_LEVEL, SUB_FIRE, 1);
+Fader fader(FADER_LEVEL, FADER_FIRE, FADER_STOP, 1);
+
+bool connectedToEos = false;
+
+/**
+ * @brief when DUMP_BTN is pressed the capture is written to box.cap for extras/host/replay.cpp
+ * and the stats of the profiler and the latency are printed, with the build flags EOS_CAPTURE,
+ * EOS_PROFILE and EOS_LATENCY
+ *
+ */
+class FilePrint : public Print {
+	public:
+		FilePrint(FILE *file) {this->file = file;}
+		using Print::write;
+		size_t write(uint8_t c) {return fputc(c, file) == EOF ? 0 : 1;}
+	private:
+		FILE *file;
+	};
+
+uint8_t dumpLast = HIGH;
+
+void dump() {
+	uint8_t level = digitalRead(DUMP_BTN);
+	if (level == LOW && dumpLast == HIGH) {
+#if EOS_CAPTURE
+		FILE *file = fopen("box.cap", "wb");
+		if (file) {
+			FilePrint out(file);
+			eos.captureDump(out);
+			fclose(file);
+			fprintf(stderr, "%u bytes captured, %u dropped\n", (unsigned)eos.captureSize(), eos.captureDropped());
+			}
+#endif
+		FilePrint report(stderr);
+		profileReport(report);
+		latencyReport(report);
+		ramReport(report);
+		}
+	dumpLast = level;
+	}
+
+void initEOS() {
+	filter("/eos/out/param/*");
+	filter("/eos/out/ping");
+	subscribe("Pan");
+	subscribe("Tilt");
+	initFaders();
+	}
+
+void parseOSCMessage(OSCMessage& msg) {
+	char address[64];
+	msg.getAddress(address, 0, sizeof(address));
+	if (msg.size() && msg.isFloat(0)) printf("%s %f\n", address, msg.getFloat(0));
+	else printf("%s\n", address);
+	}
+
+void setup() {
+	udp.begin(localPort);
+	eos.pingMessage(PING_QUERY);
+	eos.firmware("host");
+	eos.initHook(initEOS);
+	shiftButton(SHIFT_BTN);
+	encoder1.parameter("Pan");
+	encoder2.parameter("Tilt");
+	wheel.index(1);
+	pinMode(DUMP_BTN, INPUT_PULLUP);
+	eos.capture();
+	}
+
+void loop() {
+	eos.update();
+	eos.receive(parseOSCMessage);
+	if (eos.connected() != connectedToEos) {
+		connectedToEos = eos.connected();
+		printf(connectedToEos ? "connected\n" : "connection lost\n");
+		}
+	encoder1.update();
+	encoder2.update();
+	wheel.update();
+	next.update();
+	last.update();
+	go.update();
+	macro.update();
+	sub.update();
+	fader.update();
+	dump();
+	}
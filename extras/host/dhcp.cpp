@@ -0,0 +1,86 @@
+/*
+Test of the DHCP client of Ethernet3 on the simulated W5500 with the DHCP server of the stand-in,
+the first lease and the renews of beginAsync() and maintain(), with blocking the first lease comes
+from begin(mac), see extras/host/README.md
+
+usage: ./dhcp -r [blocking] [renews=2] [timeout=30]
+the stand-in must answer DHCP on port 10067, the port 67 of the simulation, e.g. ./standin -d 10067 -l 4
+renews is the number of renews to wait for, timeout the time for the test in s,
+the exit code is 0 if the lease and the renews are done in time
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <Ethernet3.h>
+
+static uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48};
+static bool blocking = false;
+static uint8_t renews = 2;
+static uint32_t timeout = 30;
+static uint8_t renewed = 0;
+static uint32_t start;
+
+static void printLease(const char *event) {
+	IPAddress ip = Ethernet.localIP();
+	IPAddress mask = Ethernet.subnetMask();
+	IPAddress gateway = Ethernet.gatewayIP();
+	IPAddress dns = Ethernet.dnsServerIP();
+	printf("%6u ms %s %u.%u.%u.%u mask %u.%u.%u.%u gateway %u.%u.%u.%u dns %u.%u.%u.%u\n", millis() - start, event,
+		ip[0], ip[1], ip[2], ip[3], mask[0], mask[1], mask[2], mask[3],
+		gateway[0], gateway[1], gateway[2], gateway[3], dns[0], dns[1], dns[2], dns[3]);
+	}
+
+void setup() {
+	for (uint8_t i = 0; simArg(i); i++) {
+		if (strcmp(simArg(i), "blocking") == 0) blocking = true;
+		else if (strncmp(simArg(i), "renews=", 7) == 0) renews = atoi(simArg(i) + 7);
+		else if (strncmp(simArg(i), "timeout=", 8) == 0) timeout = atoi(simArg(i) + 8);
+		else {
+			fprintf(stderr, "unknown argument %s\n", simArg(i));
+			exit(1);
+			}
+		}
+	start = millis();
+	if (blocking) {
+		if (Ethernet.begin(mac) != 1) {
+			printf("%6u ms no lease\n", millis() - start);
+			exit(1);
+			}
+		printLease("lease");
+		}
+	else Ethernet.beginAsync(mac);
+	}
+
+void loop() {
+	switch (Ethernet.maintain()) {
+		case DHCP_CHECK_LEASE_OK:
+			printLease("lease");
+			break;
+		case DHCP_CHECK_LEASE_FAIL:
+			printf("%6u ms no lease, requested again\n", millis() - start);
+			break;
+		case DHCP_CHECK_RENEW_OK:
+			renewed++;
+			printLease("renew");
+			break;
+		case DHCP_CHECK_REBIND_OK:
+			renewed++;
+			printLease("rebind");
+			break;
+		case DHCP_CHECK_RENEW_FAIL:
+		case DHCP_CHECK_REBIND_FAIL:
+			// the stand-in always answers
+			printf("%6u ms renew failed\n", millis() - start);
+			exit(1);
+		}
+	if (renewed >= renews) {
+		printf("%6u ms passed, %u renews\n", millis() - start, renewed);
+		exit(0);
+		}
+	if (millis() - start > timeout * 1000) {
+		printf("%6u ms timeout, %u renews\n", millis() - start, renewed);
+		exit(1);
+		}
+	}
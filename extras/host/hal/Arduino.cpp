@@ -0,0 +1,222 @@
+/*
+Simulated Arduino core for the host build of eOS, pins, ADC, clock and the script
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+EEPROMClass EEPROM;
+
+static uint8_t pinLevel[NUM_PINS];
+static uint8_t pinOut[NUM_PINS];
+static bool pinDriven[NUM_PINS]; // set by the simulation, the pullup doesn't change it
+static uint16_t adcValue[NUM_PINS];
+
+static bool realTime = false;
+static uint64_t clockUs; // virtual clock, offset of the real time clock
+static uint64_t startNs;
+
+enum event_t {EVENT_PIN, EVENT_ADC};
+
+struct Event {
+	uint64_t time; // us
+	event_t type;
+	uint8_t pin;
+	uint16_t value;
+	};
+
+static std::vector<Event> script;
+static size_t scriptPos;
+
+static uint64_t hostNs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+/**
+ * @brief analog pins can be given as channel, analogRead(0) is A0
+ *
+ */
+static uint8_t analogPin(uint8_t pin) {
+	return pin < A0 ? pin + A0 : pin;
+	}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+	if (pin >= NUM_PINS) return;
+	if (mode == INPUT_PULLUP && !pinDriven[pin]) pinLevel[pin] = HIGH;
+	}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+	if (pin < NUM_PINS) pinOut[pin] = value ? HIGH : LOW;
+	}
+
+int digitalRead(uint8_t pin) {
+	return pin < NUM_PINS ? pinLevel[pin] : LOW;
+	}
+
+int analogRead(uint8_t pin) {
+	pin = analogPin(pin);
+	return pin < NUM_PINS ? adcValue[pin] : 0;
+	}
+
+void attachInterrupt(int interrupt, void (*isr)(), int mode) {
+	}
+
+void detachInterrupt(int interrupt) {
+	}
+
+uint32_t millis() {
+	return simTime() / 1000;
+	}
+
+uint32_t micros() {
+	return simTime();
+	}
+
+void delay(uint32_t ms) {
+	delayMicroseconds(ms * 1000);
+	}
+
+void delayMicroseconds(uint32_t us) {
+	if (!realTime) {
+		clockUs += us;
+		return;
+		}
+	timespec ts = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+	nanosleep(&ts, NULL);
+	}
+
+long random(long max) {
+	return max > 0 ? rand() % max : 0;
+	}
+
+long random(long min, long max) {
+	return max > min ? min + random(max - min) : min;
+	}
+
+void randomSeed(unsigned long seed) {
+	srand(seed);
+	}
+
+void simDigital(uint8_t pin, uint8_t level) {
+	if (pin >= NUM_PINS) return;
+	pinLevel[pin] = level ? HIGH : LOW;
+	pinDriven[pin] = true;
+	}
+
+void simAnalog(uint8_t pin, uint16_t value) {
+	pin = analogPin(pin);
+	if (pin < NUM_PINS) adcValue[pin] = value > 1023 ? 1023 : value;
+	}
+
+uint8_t simOutput(uint8_t pin) {
+	return pin < NUM_PINS ? pinOut[pin] : LOW;
+	}
+
+void simVirtualTime() {
+	if (realTime) clockUs = simTime();
+	realTime = false;
+	}
+
+void simRealTime() {
+	if (!realTime) startNs = hostNs();
+	realTime = true;
+	}
+
+void simAdvance(uint32_t us) {
+	if (!realTime) clockUs += us;
+	}
+
+void simClock(uint64_t us) {
+	clockUs = us;
+	startNs = hostNs();
+	}
+
+uint64_t simTime() {
+	if (realTime) return clockUs + (hostNs() - startNs) / 1000;
+	return clockUs;
+	}
+
+/**
+ * @brief a pin of the script, a number or A0 - A15
+ *
+ */
+static bool parsePin(const char *name, uint8_t &pin) {
+	char *end;
+	long n = strtol(name[0] == 'A' ? name + 1 : name, &end, 10);
+	if (*end || n < 0) return false;
+	if (name[0] == 'A') n += A0;
+	if (n >= NUM_PINS) return false;
+	pin = n;
+	return true;
+	}
+
+static void addEvent(uint64_t time, event_t type, uint8_t pin, uint16_t value) {
+	Event event = {time, type, pin, value};
+	script.push_back(event);
+	}
+
+bool simScript(const char *path) {
+	FILE *file = fopen(path, "r");
+	if (!file) return false;
+	char line[128];
+	uint16_t number = 0;
+	bool ok = true;
+	while (fgets(line, sizeof(line), file)) {
+		number++;
+		char *comment = strchr(line, '#');
+		if (comment) *comment = 0;
+		double ms;
+		char command[16], a[16], b[16], c[16];
+		int n = sscanf(line, "%lf %15s %15s %15s %15s", &ms, command, a, b, c);
+		if (n <= 0) continue; // empty line
+		uint64_t time = simTime() + ms * 1000; // from the load of the script
+		uint8_t pin, pinB;
+		if (n == 4 && strcmp(command, "pin") == 0 && parsePin(a, pin)) {
+			addEvent(time, EVENT_PIN, pin, atoi(b));
+			}
+		else if (n == 4 && strcmp(command, "adc") == 0 && parsePin(a, pin)) {
+			addEvent(time, EVENT_ADC, pin, atoi(b));
+			}
+		else if (n == 4 && strcmp(command, "press") == 0 && parsePin(a, pin)) {
+			addEvent(time, EVENT_PIN, pin, LOW);
+			addEvent(time + atof(b) * 1000, EVENT_PIN, pin, HIGH);
+			}
+		else if (n == 5 && strcmp(command, "enc") == 0 && parsePin(a, pin) && parsePin(b, pinB)) {
+			// one falling edge of A for each step, B gives the direction
+			int steps = atoi(c);
+			for (int i = 0; i < abs(steps); i++, time += 2000) {
+				addEvent(time, EVENT_PIN, pinB, steps > 0 ? LOW : HIGH);
+				addEvent(time, EVENT_PIN, pin, LOW);
+				addEvent(time + 1000, EVENT_PIN, pin, HIGH);
+				}
+			}
+		else {
+			fprintf(stderr, "%s:%u: unknown event\n", path, number);
+			ok = false;
+			}
+		}
+	fclose(file);
+	std::stable_sort(script.begin() + scriptPos, script.end(), [](const Event &a, const Event &b) {
+		return a.time < b.time;
+		});
+	return ok;
+	}
+
+bool simScriptRun() {
+	uint64_t now = simTime();
+	while (scriptPos < script.size() && script[scriptPos].time <= now) {
+		Event &event = script[scriptPos++];
+		if (event.type == EVENT_PIN) simDigital(event.pin, event.value);
+		else simAnalog(event.pin, event.value);
+		}
+	return scriptPos < script.size();
+	}
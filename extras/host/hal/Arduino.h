@@ -0,0 +1,91 @@
+/*
+Simulated Arduino core for the host build of eOS, see extras/host/README.md
+Pins, ADC values and the clock are set by the simulation, see Sim.h
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef Arduino_h
+	#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdio.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH					1
+#define LOW						0
+#define INPUT					0
+#define OUTPUT				1
+#define INPUT_PULLUP	2
+
+#define CHANGE				1
+#define FALLING				2
+#define RISING				3
+#define NOT_AN_INTERRUPT	-1
+
+#define NUM_PINS			80 // digital and analog pins of the simulation
+#define A0						54 // like an Arduino MEGA
+#define A1						55
+#define A2						56
+#define A3						57
+#define A4						58
+#define A5						59
+#define A6						60
+#define A7						61
+#define A8						62
+#define A9						63
+#define A10						64
+#define A11						65
+#define A12						66
+#define A13						67
+#define A14						68
+#define A15						69
+#define LED_BUILTIN		13
+
+#define F(s)					(s)
+#define PROGMEM
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+
+// the simulation has no pin interrupts, a library falls back to polling
+#define digitalPinToInterrupt(pin) NOT_AN_INTERRUPT
+void attachInterrupt(int interrupt, void (*isr)(), int mode);
+void detachInterrupt(int interrupt);
+
+// 32 bit like on the boards, so the overflow after 49 days can be tested
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+void setup();
+void loop();
+
+#include "binary.h"
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "HardwareSerial.h"
+#include "IPAddress.h"
+#include "Sim.h"
+
+#endif
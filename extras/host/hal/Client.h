@@ -0,0 +1,39 @@
+/*
+Client interface of the simulated Arduino HAL, needed by the TCP transport of eOS,
+the host build has no TCP client yet, the simulated W5500 has no TCP
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef client_h
+	#define client_h
+
+#include "Stream.h"
+#include "IPAddress.h"
+
+class Client : public Stream {
+
+	public:
+
+		virtual int connect(IPAddress ip, uint16_t port) = 0;
+		virtual int connect(const char *host, uint16_t port) = 0;
+		virtual size_t write(uint8_t c) = 0;
+		virtual size_t write(const uint8_t *buffer, size_t size) = 0;
+		using Print::write;
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int read(uint8_t *buffer, size_t size) = 0;
+		virtual int peek() = 0;
+		virtual void flush() = 0;
+		virtual void stop() = 0;
+		virtual uint8_t connected() = 0;
+		virtual operator bool() = 0;
+
+	protected:
+
+		uint8_t *rawIPAddress(IPAddress &addr) {return addr.raw_address();}
+
+	};
+
+#endif
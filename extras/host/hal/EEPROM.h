@@ -0,0 +1,44 @@
+/*
+EEPROM of the simulated Arduino HAL, kept in RAM, empty cells are 0xFF like on an AVR
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef EEPROM_h
+	#define EEPROM_h
+
+#include <stdint.h>
+#include <string.h>
+
+#define EEPROM_SIZE	4096
+
+class EEPROMClass {
+
+	public:
+
+		EEPROMClass() {memset(cells, 0xFF, sizeof(cells));}
+		void begin(size_t size) {}
+		bool commit() {return true;}
+		uint8_t read(int address) {return cells[address % EEPROM_SIZE];}
+		void write(int address, uint8_t value) {cells[address % EEPROM_SIZE] = value;}
+		void update(int address, uint8_t value) {write(address, value);}
+		uint16_t length() {return EEPROM_SIZE;}
+		template <typename T> T &get(int address, T &t) {
+			memcpy(&t, cells + address, sizeof(T));
+			return t;
+			}
+		template <typename T> const T &put(int address, const T &t) {
+			memcpy(cells + address, &t, sizeof(T));
+			return t;
+			}
+
+	private:
+
+		uint8_t cells[EEPROM_SIZE];
+
+	};
+
+extern EEPROMClass EEPROM;
+
+#endif
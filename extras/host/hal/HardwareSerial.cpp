@@ -0,0 +1,91 @@
+/*
+Serial of the simulated Arduino HAL, backed by a pty
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+
+HardwareSerial Serial;
+
+const char *HardwareSerial::open() {
+	if (master >= 0) return name;
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0 || ptsname_r(master, name, sizeof(name)) != 0) {
+		perror("pty");
+		exit(1);
+		}
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+	// kept open, so the pty stays up when the other side closes it
+	slave = ::open(name, O_RDWR | O_NOCTTY);
+	termios tio;
+	if (slave >= 0 && tcgetattr(slave, &tio) == 0) {
+		cfmakeraw(&tio);
+		tcsetattr(slave, TCSANOW, &tio);
+		}
+	return name;
+	}
+
+void HardwareSerial::begin(unsigned long baud) {
+	open();
+	}
+
+void HardwareSerial::end() {
+	}
+
+void HardwareSerial::receive() {
+	if (master < 0 || rxFill == SERIAL_RX_SIZE) return;
+	uint16_t tail = (rxHead + rxFill) % SERIAL_RX_SIZE;
+	uint16_t space = tail >= rxHead ? SERIAL_RX_SIZE - tail : rxHead - tail;
+	ssize_t size = ::read(master, rx + tail, space);
+	if (size > 0) rxFill += size;
+	}
+
+int HardwareSerial::available() {
+	if (rxFill == 0) receive();
+	return rxFill;
+	}
+
+int HardwareSerial::read() {
+	if (available() == 0) return -1;
+	uint8_t c = rx[rxHead];
+	rxHead = (rxHead + 1) % SERIAL_RX_SIZE;
+	rxFill--;
+	return c;
+	}
+
+int HardwareSerial::peek() {
+	if (available() == 0) return -1;
+	return rx[rxHead];
+	}
+
+size_t HardwareSerial::write(uint8_t c) {
+	if (txFill == SERIAL_TX_SIZE) flush();
+	tx[txFill++] = c;
+	return 1;
+	}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+	for (size_t i = 0; i < size; i++) write(buffer[i]);
+	return size;
+	}
+
+void HardwareSerial::flush() {
+	if (master >= 0 && txFill) {
+		// without a reader the pty gets full, then the output is lost like on a board
+		if (::write(master, tx, txFill) < 0) setWriteError();
+		}
+	txFill = 0;
+	}
+
+const char *simSerialOpen() {
+	return Serial.open();
+	}
+
+void simSerialFlush() {
+	Serial.flush();
+	}
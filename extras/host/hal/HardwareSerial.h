@@ -0,0 +1,55 @@
+/*
+Serial of the simulated Arduino HAL, backed by a pty,
+the console or a simulation opens the other side like a USB serial port
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef HardwareSerial_h
+	#define HardwareSerial_h
+
+#include "Stream.h"
+
+#define SERIAL_TX_SIZE	1024 // output is buffered until the end of loop()
+#define SERIAL_RX_SIZE	1024
+
+class HardwareSerial : public Stream {
+
+	public:
+
+		void begin(unsigned long baud);
+		void end();
+		int available();
+		int read();
+		int peek();
+		size_t write(uint8_t c);
+		size_t write(const uint8_t *buffer, size_t size);
+		using Print::write;
+		void flush();
+		operator bool() {return true;}
+
+		/**
+		 * @brief open the pty, begin() does it also
+		 *
+		 * @return const char* name of the other side of the pty
+		 */
+		const char *open();
+
+	private:
+
+		void receive();
+		int master = -1;
+		int slave = -1;
+		char name[64];
+		uint8_t tx[SERIAL_TX_SIZE];
+		uint16_t txFill = 0;
+		uint8_t rx[SERIAL_RX_SIZE];
+		uint16_t rxHead = 0;
+		uint16_t rxFill = 0;
+
+	};
+
+extern HardwareSerial Serial;
+
+#endif
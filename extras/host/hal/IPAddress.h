@@ -0,0 +1,51 @@
+/*
+IPAddress of the simulated Arduino HAL, the bytes are in network order
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef IPAddress_h
+	#define IPAddress_h
+
+#include <stdint.h>
+#include <string.h>
+#include "Print.h"
+
+class IPAddress {
+
+	public:
+
+		IPAddress() {memset(address, 0, 4);}
+		IPAddress(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) {
+			address[0] = b0;
+			address[1] = b1;
+			address[2] = b2;
+			address[3] = b3;
+			}
+		IPAddress(uint32_t v) {memcpy(address, &v, 4);}
+		IPAddress(const uint8_t *p) {memcpy(address, p, 4);}
+
+		operator uint32_t() const {
+			uint32_t v;
+			memcpy(&v, address, 4);
+			return v;
+			}
+		bool operator==(const IPAddress &o) const {return memcmp(address, o.address, 4) == 0;}
+		bool operator!=(const IPAddress &o) const {return memcmp(address, o.address, 4) != 0;}
+		bool operator==(const uint8_t *p) const {return memcmp(address, p, 4) == 0;}
+		uint8_t operator[](int i) const {return address[i];}
+		uint8_t &operator[](int i) {return address[i];}
+		IPAddress &operator=(const uint8_t *p) {memcpy(address, p, 4); return *this;}
+		IPAddress &operator=(uint32_t v) {memcpy(address, &v, 4); return *this;}
+		uint8_t *raw_address() {return address;}
+
+	private:
+
+		uint8_t address[4];
+
+	};
+
+extern const IPAddress INADDR_NONE;
+
+#endif
@@ -0,0 +1,65 @@
+/*
+LiquidCrystal of the simulated Arduino HAL, the display is kept as text,
+so the examples with a LCD can run on the host
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef LiquidCrystal_h
+	#define LiquidCrystal_h
+
+#include "Print.h"
+
+#define LCD_COLS_MAX	40
+#define LCD_ROWS_MAX	4
+
+class LiquidCrystal : public Print {
+
+	public:
+
+		LiquidCrystal(uint8_t rs, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7) {clear();}
+		LiquidCrystal(uint8_t rs, uint8_t rw, uint8_t enable, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7) {clear();}
+		void begin(uint8_t cols, uint8_t rows) {
+			this->cols = cols < LCD_COLS_MAX ? cols : LCD_COLS_MAX;
+			this->rows = rows < LCD_ROWS_MAX ? rows : LCD_ROWS_MAX;
+			clear();
+			}
+		void clear() {
+			memset(text, ' ', sizeof(text));
+			for (uint8_t r = 0; r < LCD_ROWS_MAX; r++) text[r][LCD_COLS_MAX] = 0;
+			col = row = 0;
+			}
+		void home() {col = row = 0;}
+		void createChar(uint8_t location, uint8_t charmap[]) {}
+		void setCursor(uint8_t col, uint8_t row) {
+			this->col = col;
+			this->row = row < rows ? row : rows - 1;
+			}
+		size_t write(uint8_t c) {
+			if (col >= cols) return 0;
+			text[row][col++] = c;
+			return 1;
+			}
+		using Print::write;
+
+		/**
+		 * @brief the text of a row, for tests
+		 *
+		 */
+		const char *line(uint8_t row) {
+			text[row][cols] = 0;
+			return text[row];
+			}
+
+	private:
+
+		char text[LCD_ROWS_MAX][LCD_COLS_MAX + 1];
+		uint8_t cols = 16;
+		uint8_t rows = 2;
+		uint8_t col;
+		uint8_t row;
+
+	};
+
+#endif
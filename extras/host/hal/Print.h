@@ -0,0 +1,69 @@
+/*
+Print of the simulated Arduino HAL
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef Print_h
+	#define Print_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC		10
+#define HEX		16
+
+class Print {
+
+	public:
+
+		virtual ~Print() {}
+		virtual size_t write(uint8_t c) = 0;
+		virtual size_t write(const uint8_t *buffer, size_t size) {
+			size_t n = 0;
+			while (size--) n += write(*buffer++);
+			return n;
+			}
+		size_t write(const char *str) {return str ? write((const uint8_t*)str, strlen(str)) : 0;}
+		size_t write(const char *buffer, size_t size) {return write((const uint8_t*)buffer, size);}
+		virtual void flush() {}
+
+		size_t print(const char *str) {return write(str);}
+		size_t print(const String &str) {return write(str.c_str());}
+		size_t print(char c) {return write((uint8_t)c);}
+		size_t print(long v, int base = DEC) {return number(base == HEX ? "%lx" : "%ld", v);}
+		size_t print(unsigned long v, int base = DEC) {return number(base == HEX ? "%lx" : "%lu", v);}
+		size_t print(int v, int base = DEC) {return print((long)v, base);}
+		size_t print(unsigned int v, int base = DEC) {return print((unsigned long)v, base);}
+		size_t print(unsigned char v, int base = DEC) {return print((unsigned long)v, base);}
+		size_t print(double v, int decimals = 2) {
+			char b[32];
+			snprintf(b, sizeof(b), "%.*f", decimals, v);
+			return write(b);
+			}
+		size_t println() {return write("\r\n");}
+		template <typename T> size_t println(const T &v) {return print(v) + println();}
+		template <typename T> size_t println(const T &v, int format) {return print(v, format) + println();}
+
+		int getWriteError() {return writeError;}
+		void clearWriteError() {writeError = 0;}
+
+	protected:
+
+		void setWriteError(int error = 1) {writeError = error;}
+
+	private:
+
+		template <typename T> size_t number(const char *format, T v) {
+			char b[24];
+			snprintf(b, sizeof(b), format, v);
+			return write(b);
+			}
+		int writeError = 0;
+
+	};
+
+#endif
@@ -0,0 +1,46 @@
+/*
+SPI of the simulated Arduino HAL, the only device on the bus is the
+simulated W5500 of SimW5500.cpp, a transaction is one CS cycle of the chip
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef SPI_h
+	#define SPI_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LSBFIRST			0
+#define MSBFIRST			1
+#define SPI_MODE0			0x00
+#define SPI_MODE1			0x04
+#define SPI_MODE2			0x08
+#define SPI_MODE3			0x0C
+
+class SPISettings {
+
+	public:
+
+		SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0) : clock(clock) {}
+		uint32_t clock;
+
+	};
+
+class SPIClass {
+
+	public:
+
+		void begin();
+		void end();
+		void beginTransaction(SPISettings settings);
+		void endTransaction();
+		uint8_t transfer(uint8_t data);
+		void transfer(void *buffer, size_t size);
+
+	};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,21 @@
+/*
+Server interface of the simulated Arduino HAL, needed by Ethernet3
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef server_h
+	#define server_h
+
+#include "Print.h"
+
+class Server : public Print {
+
+	public:
+
+		virtual void begin() = 0;
+
+	};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+Control of the simulated Arduino HAL, used by the host main() and by tests
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef SIM_H
+	#define SIM_H
+
+#include <stdint.h>
+
+/**
+ * @brief set the level of a digital input, the pullup of an open button is HIGH
+ *
+ * @param pin digital pin
+ * @param level HIGH or LOW
+ */
+void simDigital(uint8_t pin, uint8_t level);
+
+/**
+ * @brief set the value of an analog input
+ *
+ * @param pin analog pin
+ * @param value 0 - 1023
+ */
+void simAnalog(uint8_t pin, uint16_t value);
+
+/**
+ * @brief get the level a sketch has written to a pin
+ *
+ * @param pin digital pin
+ * @return uint8_t HIGH or LOW
+ */
+uint8_t simOutput(uint8_t pin);
+
+/**
+ * @brief use the virtual clock, it only moves with simAdvance() and delay(),
+ * standard, so a run is always the same
+ *
+ */
+void simVirtualTime();
+
+/**
+ * @brief use the monotonic clock of the host, needed with a real console or the stand-in
+ *
+ */
+void simRealTime();
+
+/**
+ * @brief move the virtual clock
+ *
+ * @param us microseconds
+ */
+void simAdvance(uint32_t us);
+
+/**
+ * @brief set the virtual clock, e.g. short before the overflow of millis()
+ *
+ * @param us microseconds since the start
+ */
+void simClock(uint64_t us);
+
+/**
+ * @brief the clock of the simulation without overflow
+ *
+ * @return uint64_t microseconds since the start
+ */
+uint64_t simTime();
+
+/**
+ * @brief load a script with pin and ADC values, the times start with the load, see extras/host/README.md
+ *
+ * @param path of the script
+ * @return true if the script was loaded
+ */
+bool simScript(const char *path);
+
+/**
+ * @brief apply the events of the script which are due
+ *
+ * @return true as long as events are pending
+ */
+bool simScriptRun();
+
+/**
+ * @brief open the pty of Serial
+ *
+ * @return const char* name of the pty for the other side, e.g. /dev/pts/3
+ */
+const char *simSerialOpen();
+
+/**
+ * @brief write the buffered output of Serial to the pty
+ *
+ */
+void simSerialFlush();
+
+/**
+ * @brief get an argument of the command line after the options, e.g. a file for the sketch
+ *
+ * @param index of the argument
+ * @return const char* argument, NULL if there are less arguments
+ */
+const char *simArg(uint8_t index);
+
+/**
+ * @brief SPI transactions with the simulated W5500 of SimW5500.cpp, each is one CS cycle
+ *
+ * @return uint32_t transactions since the start or simSpiReset()
+ */
+uint32_t simSpiTransactions();
+
+/**
+ * @brief bytes on the SPI bus of the simulated W5500 with the 3 byte header of each transaction,
+ * a byte takes 8 cycles of the SPI clock
+ *
+ * @return uint32_t bytes since the start or simSpiReset()
+ */
+uint32_t simSpiBytes();
+
+/**
+ * @brief clear the SPI counters of the simulated W5500
+ *
+ */
+void simSpiReset();
+
+#endif
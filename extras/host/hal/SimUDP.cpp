@@ -0,0 +1,138 @@
+/*
+UDP of the simulated Arduino HAL, backed by a POSIX socket
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "SimUDP.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+SimUDP::~SimUDP() {
+	stop();
+	}
+
+bool SimUDP::open(uint16_t port) {
+	stop();
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0) return false;
+	int on = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)); // for the discovery
+	fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+	sockaddr_in local = {};
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons(port);
+	if (bind(sock, (sockaddr*)&local, sizeof(local)) < 0) {
+		perror("udp");
+		stop();
+		return false;
+		}
+	return true;
+	}
+
+uint8_t SimUDP::begin(uint16_t port) {
+	return open(port);
+	}
+
+void SimUDP::stop() {
+	if (sock >= 0) close(sock);
+	sock = -1;
+	rxSize = rxPos = 0;
+	}
+
+int SimUDP::beginPacket(IPAddress ip, uint16_t port) {
+	if (sock < 0 && !open(0)) return 0; // sending without begin() uses any port
+	txIP = ip;
+	txPort = port;
+	txFill = 0;
+	txOverflow = false;
+	return 1;
+	}
+
+int SimUDP::beginPacket(const char *host, uint16_t port) {
+	addrinfo hints = {}, *result;
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+	if (getaddrinfo(host, NULL, &hints, &result) != 0) return 0;
+	uint32_t address = ((sockaddr_in*)result->ai_addr)->sin_addr.s_addr;
+	freeaddrinfo(result);
+	return beginPacket(IPAddress(address), port);
+	}
+
+int SimUDP::endPacket() {
+	if (sock < 0 || txOverflow) return 0;
+	sockaddr_in remote = {};
+	remote.sin_family = AF_INET;
+	remote.sin_addr.s_addr = (uint32_t)txIP;
+	remote.sin_port = htons(txPort);
+	return sendto(sock, tx, txFill, 0, (sockaddr*)&remote, sizeof(remote)) == txFill;
+	}
+
+size_t SimUDP::write(uint8_t c) {
+	if (txFill == SIMUDP_PACKET_SIZE) {
+		txOverflow = true;
+		return 0;
+		}
+	tx[txFill++] = c;
+	return 1;
+	}
+
+size_t SimUDP::write(const uint8_t *buffer, size_t size) {
+	size_t n = 0;
+	while (n < size && write(buffer[n])) n++;
+	return n;
+	}
+
+int SimUDP::parsePacket() {
+	rxSize = rxPos = 0;
+	if (sock < 0) return 0;
+	sockaddr_in remote;
+	socklen_t remoteSize = sizeof(remote);
+	ssize_t size = recvfrom(sock, rx, sizeof(rx), 0, (sockaddr*)&remote, &remoteSize);
+	if (size <= 0) return 0;
+	rxSize = size;
+	rxIP = IPAddress((uint32_t)remote.sin_addr.s_addr);
+	rxPort = ntohs(remote.sin_port);
+	return rxSize;
+	}
+
+int SimUDP::available() {
+	return rxSize - rxPos;
+	}
+
+int SimUDP::read() {
+	return rxPos < rxSize ? rx[rxPos++] : -1;
+	}
+
+int SimUDP::read(unsigned char *buffer, size_t size) {
+	size_t n = 0;
+	while (n < size && rxPos < rxSize) buffer[n++] = rx[rxPos++];
+	return n;
+	}
+
+int SimUDP::read(char *buffer, size_t size) {
+	return read((unsigned char*)buffer, size);
+	}
+
+int SimUDP::peek() {
+	return rxPos < rxSize ? rx[rxPos] : -1;
+	}
+
+void SimUDP::flush() {
+	rxPos = rxSize;
+	}
+
+IPAddress SimUDP::remoteIP() {
+	return rxIP;
+	}
+
+uint16_t SimUDP::remotePort() {
+	return rxPort;
+	}
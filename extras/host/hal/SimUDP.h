@@ -0,0 +1,56 @@
+/*
+UDP of the simulated Arduino HAL, backed by a POSIX socket,
+it replaces EthernetUDP on the host
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef SIMUDP_H
+	#define SIMUDP_H
+
+#include "Udp.h"
+
+#define SIMUDP_PACKET_SIZE	1472 // max payload of an Ethernet frame
+
+class SimUDP : public UDP {
+
+	public:
+
+		~SimUDP();
+		uint8_t begin(uint16_t port);
+		void stop();
+		int beginPacket(IPAddress ip, uint16_t port);
+		int beginPacket(const char *host, uint16_t port);
+		int endPacket();
+		size_t write(uint8_t c);
+		size_t write(const uint8_t *buffer, size_t size);
+		using Print::write;
+		int parsePacket();
+		int available();
+		int read();
+		int read(unsigned char *buffer, size_t size);
+		int read(char *buffer, size_t size);
+		int peek();
+		void flush();
+		IPAddress remoteIP();
+		uint16_t remotePort();
+
+	private:
+
+		bool open(uint16_t port);
+		int sock = -1;
+		IPAddress txIP;
+		uint16_t txPort = 0;
+		uint8_t tx[SIMUDP_PACKET_SIZE];
+		uint16_t txFill = 0;
+		bool txOverflow = false;
+		uint8_t rx[SIMUDP_PACKET_SIZE];
+		uint16_t rxSize = 0;
+		uint16_t rxPos = 0;
+		IPAddress rxIP;
+		uint16_t rxPort = 0;
+
+	};
+
+#endif
@@ -0,0 +1,339 @@
+/*
+W5500 of the simulated Arduino HAL behind the SPI bus, so Ethernet3 runs unchanged
+on the host, the UDP sockets of the chip are POSIX sockets, see extras/host/README.md
+- the registers, the Tx and Rx memory and the commands OPEN, CLOSE, SEND and RECV of UDP,
+  a written Sn_TX_WR is read back after SEND like on the chip
+- a datagram waits in the host socket until the Rx memory of the chip has room for it
+- ports below 1024 are moved by W5500_PORT_OFFSET, they need root on Linux,
+  a received port in this range is moved back, so DHCP and DNS see 67 and 53
+- the limited broadcast 255.255.255.255 goes to 127.0.0.1, e.g. to the DHCP server of the stand-in
+- TCP sockets never connect, there is no TCP yet
+- the SPI transactions and the bytes on the bus are counted for the tests
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include "SPI.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+#define W5500_SOCKETS			8
+#define W5500_MEMORY			16384 // Tx and Rx memory of the chip, the most a socket can have
+#define W5500_PORT_OFFSET	10000
+
+// registers of the datasheet which the simulation handles itself
+#define MR			0x00
+#define IR			0x15
+#define SIR			0x17
+#define PHYCFGR	0x2E
+#define VERSIONR	0x39
+#define Sn_MR		0x00
+#define Sn_CR		0x01
+#define Sn_IR		0x02
+#define Sn_SR		0x03
+#define Sn_PORT	0x04
+#define Sn_DIPR	0x0C
+#define Sn_DPORT	0x10
+#define Sn_RXBUF	0x1E
+#define Sn_TXBUF	0x1F
+#define Sn_TX_FSR	0x20
+#define Sn_TX_RD	0x22
+#define Sn_TX_WR	0x24
+#define Sn_RX_RSR	0x26
+#define Sn_RX_RD	0x28
+#define Sn_RX_WR	0x2A
+#define Sn_IMR		0x2C
+
+SPIClass SPI;
+
+struct Socket {
+	uint8_t reg[0x30];
+	uint16_t txRead;
+	uint16_t txWrite;
+	uint16_t txWriteNext; // a written Sn_TX_WR is read back after SEND, a UDP packet is built with offsets to it
+	uint16_t rxRead;
+	uint16_t rxWrite;
+	uint8_t tx[W5500_MEMORY];
+	uint8_t rx[W5500_MEMORY];
+	int fd;
+	};
+
+static uint8_t common[0x40];
+static Socket sockets[W5500_SOCKETS];
+static bool powered = false;
+
+// the frame of the running transaction, 2 bytes address and the control byte
+static uint8_t header[3];
+static uint8_t headerFill;
+static uint16_t frameAddress;
+static uint8_t frameBlock;
+static bool frameWrite;
+
+static uint32_t spiTransactions;
+static uint32_t spiBytes;
+
+static uint16_t port(const uint8_t *reg) {
+	return (reg[0] << 8) | reg[1];
+	}
+
+static uint16_t hostPort(uint16_t port) {
+	return port < 1024 ? port + W5500_PORT_OFFSET : port;
+	}
+
+static uint16_t chipPort(uint16_t port) {
+	return port >= W5500_PORT_OFFSET && port < W5500_PORT_OFFSET + 1024 ? port - W5500_PORT_OFFSET : port;
+	}
+
+// Tx or Rx memory of a socket in KB, 0 - 16
+static uint16_t memoryMask(uint8_t kb) {
+	return kb ? (kb > 16 ? 16 : kb) * 1024 - 1 : 0;
+	}
+
+static void closeSocket(Socket &sn) {
+	if (sn.fd >= 0) close(sn.fd);
+	sn.fd = -1;
+	sn.reg[Sn_SR] = 0x00; // CLOSED
+	}
+
+static void reset() {
+	for (uint8_t s = 0; s < W5500_SOCKETS; s++) {
+		Socket &sn = sockets[s];
+		if (powered) closeSocket(sn);
+		memset(sn.reg, 0, sizeof(sn.reg));
+		sn.reg[Sn_RXBUF] = 2;
+		sn.reg[Sn_TXBUF] = 2;
+		sn.reg[Sn_IMR] = 0xFF;
+		sn.txRead = sn.txWrite = sn.txWriteNext = sn.rxRead = sn.rxWrite = 0;
+		sn.fd = -1;
+		}
+	memset(common, 0, sizeof(common));
+	common[0x19] = 0x07; // RTR 200ms
+	common[0x1A] = 0xD0;
+	common[0x1B] = 8; // RCR
+	common[PHYCFGR] = 0xBF; // link up, 100 Mbit full duplex
+	common[VERSIONR] = 0x04;
+	powered = true;
+	}
+
+static bool openSocket(Socket &sn) {
+	sn.fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sn.fd < 0) return false;
+	int on = 1;
+	setsockopt(sn.fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	setsockopt(sn.fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+	fcntl(sn.fd, F_SETFL, fcntl(sn.fd, F_GETFL) | O_NONBLOCK);
+	sockaddr_in local = {};
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons(hostPort(port(sn.reg + Sn_PORT)));
+	if (bind(sn.fd, (sockaddr*)&local, sizeof(local)) < 0) {
+		perror("w5500");
+		closeSocket(sn);
+		return false;
+		}
+	return true;
+	}
+
+/**
+ * @brief send the data between Sn_TX_RD and Sn_TX_WR to Sn_DIPR and Sn_DPORT
+ *
+ */
+static void sendData(Socket &sn) {
+	uint16_t mask = memoryMask(sn.reg[Sn_TXBUF]);
+	sn.txWrite = sn.txWriteNext;
+	uint16_t size = sn.txWrite - sn.txRead;
+	if (size > mask + 1) size = mask + 1;
+	uint8_t packet[W5500_MEMORY];
+	for (uint16_t i = 0; i < size; i++) packet[i] = sn.tx[(uint16_t)(sn.txRead + i) & mask];
+	sn.txRead = sn.txWrite;
+	sockaddr_in remote = {};
+	remote.sin_family = AF_INET;
+	memcpy(&remote.sin_addr.s_addr, sn.reg + Sn_DIPR, 4);
+	if (remote.sin_addr.s_addr == htonl(INADDR_BROADCAST)) remote.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	remote.sin_port = htons(hostPort(port(sn.reg + Sn_DPORT)));
+	bool sent = sn.fd >= 0 && sendto(sn.fd, packet, size, 0, (sockaddr*)&remote, sizeof(remote)) == size;
+	sn.reg[Sn_IR] |= sent ? 0x10 : 0x08; // SEND_OK or TIMEOUT
+	}
+
+/**
+ * @brief move the datagrams of the host socket into the Rx memory with the 8 byte header of the chip
+ *
+ */
+static void receive(Socket &sn) {
+	if (sn.fd < 0 || !sn.reg[Sn_RXBUF]) return;
+	uint16_t mask = memoryMask(sn.reg[Sn_RXBUF]);
+	uint16_t size = mask + 1;
+	while (true) {
+		uint8_t packet[W5500_MEMORY];
+		sockaddr_in remote;
+		socklen_t remoteSize = sizeof(remote);
+		ssize_t length = recvfrom(sn.fd, packet, sizeof(packet), MSG_PEEK | MSG_TRUNC, (sockaddr*)&remote, &remoteSize);
+		if (length < 0) return;
+		if (8 + length <= size && 8 + length > size - (uint16_t)(sn.rxWrite - sn.rxRead)) return; // waits for room
+		recvfrom(sn.fd, packet, sizeof(packet), 0, (sockaddr*)&remote, &remoteSize);
+		if (8 + length > size) continue; // never fits, the chip drops it
+		uint8_t head[8];
+		memcpy(head, &remote.sin_addr.s_addr, 4);
+		uint16_t from = chipPort(ntohs(remote.sin_port));
+		head[4] = from >> 8;
+		head[5] = from & 0xFF;
+		head[6] = length >> 8;
+		head[7] = length & 0xFF;
+		for (uint8_t i = 0; i < 8; i++) sn.rx[sn.rxWrite++ & mask] = head[i];
+		for (ssize_t i = 0; i < length; i++) sn.rx[sn.rxWrite++ & mask] = packet[i];
+		sn.reg[Sn_IR] |= 0x04; // RECV
+		}
+	}
+
+static void command(Socket &sn, uint8_t cmd) {
+	switch (cmd) {
+		case 0x01: // OPEN
+			closeSocket(sn);
+			sn.txRead = sn.txWrite = sn.txWriteNext = sn.rxRead = sn.rxWrite = 0;
+			if ((sn.reg[Sn_MR] & 0x0F) == 0x02 && openSocket(sn)) sn.reg[Sn_SR] = 0x22; // UDP
+			else if ((sn.reg[Sn_MR] & 0x0F) == 0x01) sn.reg[Sn_SR] = 0x13; // INIT of TCP
+			break;
+		case 0x02: // LISTEN
+			if (sn.reg[Sn_SR] == 0x13) sn.reg[Sn_SR] = 0x14;
+			break;
+		case 0x04: // CONNECT, there is no TCP peer
+			closeSocket(sn);
+			sn.reg[Sn_IR] |= 0x08; // TIMEOUT
+			break;
+		case 0x08: // DISCON
+		case 0x10: // CLOSE
+			closeSocket(sn);
+			break;
+		case 0x20: // SEND
+			sendData(sn);
+			break;
+		case 0x40: // RECV, Sn_RX_RD was moved already
+			break;
+		}
+	}
+
+static uint8_t readRegister(Socket &sn, uint16_t address) {
+	uint16_t value;
+	switch (address & 0xFFFE) {
+		case Sn_TX_FSR: value = (sn.reg[Sn_TXBUF] ? memoryMask(sn.reg[Sn_TXBUF]) + 1 : 0) - (uint16_t)(sn.txWrite - sn.txRead); break;
+		case Sn_TX_RD: value = sn.txRead; break;
+		case Sn_TX_WR: value = sn.txWrite; break;
+		case Sn_RX_RSR: value = sn.rxWrite - sn.rxRead; break;
+		case Sn_RX_RD: value = sn.rxRead; break;
+		case Sn_RX_WR: value = sn.rxWrite; break;
+		default:
+			if (address == Sn_CR) return 0; // a command is done at once
+			return address < sizeof(sn.reg) ? sn.reg[address] : 0;
+		}
+	return address & 1 ? value & 0xFF : value >> 8;
+	}
+
+static void writeRegister(Socket &sn, uint16_t address, uint8_t data) {
+	switch (address) {
+		case Sn_CR: command(sn, data); return;
+		case Sn_IR: sn.reg[Sn_IR] &= ~data; return;
+		case Sn_TX_WR: sn.txWriteNext = (sn.txWriteNext & 0x00FF) | (data << 8); return;
+		case Sn_TX_WR + 1: sn.txWriteNext = (sn.txWriteNext & 0xFF00) | data; return;
+		case Sn_RX_RD: sn.rxRead = (sn.rxRead & 0x00FF) | (data << 8); return;
+		case Sn_RX_RD + 1: sn.rxRead = (sn.rxRead & 0xFF00) | data; return;
+		case Sn_SR:
+		case Sn_TX_FSR: case Sn_TX_FSR + 1: case Sn_TX_RD: case Sn_TX_RD + 1:
+		case Sn_RX_RSR: case Sn_RX_RSR + 1: case Sn_RX_WR: case Sn_RX_WR + 1:
+			return; // read only
+		}
+	if (address < sizeof(sn.reg)) sn.reg[address] = data;
+	}
+
+static uint8_t readByte(uint8_t block, uint16_t address) {
+	if (block == 0) {
+		if (address == SIR) {
+			uint8_t sir = 0;
+			for (uint8_t s = 0; s < W5500_SOCKETS; s++) {
+				if (sockets[s].reg[Sn_IR] & sockets[s].reg[Sn_IMR]) sir |= 1 << s;
+				}
+			return sir;
+			}
+		return address < sizeof(common) ? common[address] : 0;
+		}
+	Socket &sn = sockets[(block >> 2) & 0x07];
+	switch (block & 0x03) {
+		case 1: return readRegister(sn, address);
+		case 2: return sn.tx[address & memoryMask(sn.reg[Sn_TXBUF])];
+		case 3: return sn.rx[address & memoryMask(sn.reg[Sn_RXBUF])];
+		}
+	return 0;
+	}
+
+static void writeByte(uint8_t block, uint16_t address, uint8_t data) {
+	if (block == 0) {
+		if (address == MR && (data & 0x80)) reset();
+		else if (address == IR) common[IR] &= ~data;
+		else if (address != SIR && address != VERSIONR && address < sizeof(common)) common[address] = data;
+		return;
+		}
+	Socket &sn = sockets[(block >> 2) & 0x07];
+	switch (block & 0x03) {
+		case 1: writeRegister(sn, address, data); break;
+		case 2: if (sn.reg[Sn_TXBUF]) sn.tx[address & memoryMask(sn.reg[Sn_TXBUF])] = data; break;
+		case 3: if (sn.reg[Sn_RXBUF]) sn.rx[address & memoryMask(sn.reg[Sn_RXBUF])] = data; break;
+		}
+	}
+
+void SPIClass::begin() {
+	if (!powered) reset();
+	}
+
+void SPIClass::end() {
+	}
+
+void SPIClass::beginTransaction(SPISettings settings) {
+	if (!powered) reset();
+	spiTransactions++;
+	headerFill = 0;
+	}
+
+void SPIClass::endTransaction() {
+	headerFill = 0;
+	}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+	spiBytes++;
+	if (headerFill < 3) {
+		header[headerFill++] = data;
+		if (headerFill == 3) {
+			frameAddress = (header[0] << 8) | header[1];
+			frameBlock = header[2] >> 3;
+			frameWrite = header[2] & 0x04;
+			// new datagrams show up when the registers of the socket are read
+			if ((frameBlock & 0x03) == 1 && !frameWrite) receive(sockets[(frameBlock >> 2) & 0x07]);
+			}
+		return 0;
+		}
+	if (frameWrite) {
+		writeByte(frameBlock, frameAddress++, data);
+		return 0;
+		}
+	return readByte(frameBlock, frameAddress++);
+	}
+
+void SPIClass::transfer(void *buffer, size_t size) {
+	uint8_t *data = (uint8_t*)buffer;
+	for (size_t i = 0; i < size; i++) data[i] = transfer(data[i]);
+	}
+
+uint32_t simSpiTransactions() {
+	return spiTransactions;
+	}
+
+uint32_t simSpiBytes() {
+	return spiBytes;
+	}
+
+void simSpiReset() {
+	spiTransactions = 0;
+	spiBytes = 0;
+	}
@@ -0,0 +1,28 @@
+/*
+Stream of the simulated Arduino HAL
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef Stream_h
+	#define Stream_h
+
+#include "Print.h"
+
+class Stream : public Print {
+
+	public:
+
+		virtual int available() = 0;
+		virtual int read() = 0;
+		virtual int peek() = 0;
+		size_t readBytes(uint8_t *buffer, size_t length) {
+			size_t n = 0;
+			while (n < length && available() > 0) buffer[n++] = read();
+			return n;
+			}
+
+	};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+String of the simulated Arduino HAL, based on std::string
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#ifndef WString_h
+	#define WString_h
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+
+class String {
+
+	public:
+
+		String(const char *s = "") : s(s ? s : "") {}
+		String(const String &o) : s(o.s) {}
+		String(char c) : s(1, c) {}
+		String(int v) : s(std::to_string(v)) {}
+		String(unsigned int v) : s(std::to_string(v)) {}
+		String(long v) : s(std::to_string(v)) {}
+		String(unsigned long v) : s(std::to_string(v)) {}
+		String(unsigned char v) : s(std::to_string(v)) {}
+		String(float v, unsigned char decimals = 2) {
+			char b[32];
+			snprintf(b, sizeof(b), "%.*f", decimals, v);
+			s = b;
+			}
+		String(double v, unsigned char decimals = 2) {
+			char b[32];
+			snprintf(b, sizeof(b), "%.*f", decimals, v);
+			s = b;
+			}
+
+		String &operator=(const String &o) {s = o.s; return *this;}
+		String &operator=(const char *o) {s = o ? o : ""; return *this;}
+
+		const char *c_str() const {return s.c_str();}
+		unsigned int length() const {return s.size();}
+		void reserve(unsigned int size) {s.reserve(size);}
+
+		String &operator+=(const String &o) {s += o.s; return *this;}
+		String &operator+=(const char *o) {s += o; return *this;}
+		String &operator+=(char c) {s += c; return *this;}
+		String &operator+=(int v) {s += std::to_string(v); return *this;}
+		String &operator+=(unsigned int v) {s += std::to_string(v); return *this;}
+		String &operator+=(long v) {s += std::to_string(v); return *this;}
+		String &operator+=(unsigned long v) {s += std::to_string(v); return *this;}
+		String &operator+=(unsigned char v) {s += std::to_string(v); return *this;}
+		bool concat(const String &o) {s += o.s; return true;}
+
+		friend String operator+(const String &a, const String &b) {String r(a); r += b; return r;}
+		friend String operator+(const String &a, const char *b) {String r(a); r += b; return r;}
+		friend String operator+(const char *a, const String &b) {String r(a); r += b; return r;}
+		friend String operator+(const String &a, char b) {String r(a); r += b; return r;}
+		friend String operator+(char a, const String &b) {String r(a); r += b; return r;}
+
+		bool operator==(const String &o) const {return s == o.s;}
+		bool operator==(const char *o) const {return s == (o ? o : "");}
+		bool operator!=(const String &o) const {return s != o.s;}
+		bool operator!=(const char *o) const {return s != (o ? o : "");}
+		bool equals(const String &o) const {return s == o.s;}
+		char operator[](unsigned int i) const {return i < s.size() ? s[i] : 0;}
+		char &operator[](unsigned int i) {return s[i];}
+		char charAt(unsigned int i) const {return i < s.size() ? s[i] : 0;}
+
+		int indexOf(char c, unsigned int from = 0) const {return found(s.find(c, from));}
+		int indexOf(const char *t, unsigned int from = 0) const {return found(s.find(t, from));}
+		int indexOf(const String &t, unsigned int from = 0) const {return found(s.find(t.s, from));}
+		int lastIndexOf(char c) const {return found(s.rfind(c));}
+		int lastIndexOf(const char *t) const {return found(s.rfind(t));}
+		int lastIndexOf(const char *t, int from) const {return from < 0 ? -1 : found(s.rfind(t, from));}
+		String substring(unsigned int begin) const {
+			return begin >= s.size() ? String() : String(s.substr(begin).c_str());
+			}
+		String substring(unsigned int begin, unsigned int end) const {
+			if (begin > end) std::swap(begin, end);
+			return begin >= s.size() ? String() : String(s.substr(begin, end - begin).c_str());
+			}
+		bool startsWith(const String &prefix) const {return s.compare(0, prefix.s.size(), prefix.s) == 0;}
+		bool endsWith(const String &suffix) const {
+			return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+			}
+		void toUpperCase() {for (size_t i = 0; i < s.size(); i++) s[i] = toupper(s[i]);}
+		void toLowerCase() {for (size_t i = 0; i < s.size(); i++) s[i] = tolower(s[i]);}
+		void trim() {
+			size_t begin = s.find_first_not_of(" \t\r\n");
+			size_t end = s.find_last_not_of(" \t\r\n");
+			s = begin == std::string::npos ? "" : s.substr(begin, end - begin + 1);
+			}
+		long toInt() const {return atol(s.c_str());}
+		float toFloat() const {return atof(s.c_str());}
+
+	private:
+
+		static int found(size_t pos) {return pos == std::string::npos ? -1 : (int)pos;}
+		std::string s;
+
+	};
+
+#endif
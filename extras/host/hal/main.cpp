@@ -0,0 +1,87 @@
+/*
+main() of the simulated Arduino core, runs setup() and loop() of the sketch
+
+usage: ./box [-s script] [-t ms] [-u us] [-c ms] [-r] [args of the sketch]
+-s script with pin and ADC values, see extras/host/README.md
+-t stop after ms of simulated time, the loops per second are printed then
+-u simulated time of one loop in us, standard 100
+-c start of the clock in ms, e.g. 4294960 tests the overflow of millis()
+-r real time clock, needed with a console or the stand-in
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
+static volatile bool running = true;
+static char **args;
+static int argCount;
+
+static void stop(int signal) {
+	running = false;
+	}
+
+const char *simArg(uint8_t index) {
+	return index < argCount ? args[index] : NULL;
+	}
+
+static uint64_t hostUs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+
+int main(int argc, char *argv[]) {
+	const char *script = NULL;
+	uint64_t duration = 0;
+	uint32_t tick = 100;
+	bool real = false;
+	int opt;
+	while ((opt = getopt(argc, argv, "s:t:u:c:r")) != -1) {
+		switch (opt) {
+			case 's': script = optarg; break;
+			case 't': duration = strtoull(optarg, NULL, 10) * 1000; break;
+			case 'u': tick = strtoul(optarg, NULL, 10); break;
+			case 'c': simClock(strtoull(optarg, NULL, 10) * 1000); break;
+			case 'r': real = true; break;
+			default:
+				fprintf(stderr, "usage: %s [-s script] [-t ms] [-u us] [-c ms] [-r] [args of the sketch]\n", argv[0]);
+				return 1;
+			}
+		}
+	args = argv + optind;
+	argCount = argc - optind;
+	if (script && !simScript(script)) {
+		fprintf(stderr, "can't load %s\n", script);
+		return 1;
+		}
+	if (real) simRealTime();
+	signal(SIGINT, stop);
+	signal(SIGTERM, stop);
+	fprintf(stderr, "Serial on %s\n", simSerialOpen());
+
+	uint64_t start = simTime();
+	uint64_t hostStart = hostUs();
+	uint64_t loops = 0;
+	simScriptRun();
+	setup();
+	simSerialFlush();
+	while (running && (!duration || simTime() - start < duration)) {
+		simScriptRun();
+		loop();
+		simSerialFlush();
+		loops++;
+		if (real) usleep(tick);
+		else simAdvance(tick);
+		}
+
+	uint64_t hostTime = hostUs() - hostStart;
+	fprintf(stderr, "%llu loops in %llu ms simulated, %llu ms on the host, %.0f ns per loop\n",
+		(unsigned long long)loops, (unsigned long long)(simTime() - start) / 1000,
+		(unsigned long long)hostTime / 1000, loops ? hostTime * 1000.0 / loops : 0.0);
+	return 0;
+	}
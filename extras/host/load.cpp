@@ -0,0 +1,285 @@
+/*
+Load generator for the host build, up to 16 virtual boxes with an own socket,
+an encoder, a fader and a key each are driven against a console or the stand-in,
+the messages per second, the packet sizes and the send jitter of each box are reported,
+see extras/host/README.md
+
+usage: ./load -r [options of the host build] [boxes=4] [ip=127.0.0.1] [port=8000]
+	[enc=20] [fader=1] [key=0.5] [report=5]
+enc, fader and key are the events per second of each box, report is the interval in s
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <OSCMessage.h>
+#include "eOS.h"
+#include "SimUDP.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define BOXES_MAX		16 // 3 digital pins for each box below A0 and A0 - A15 for the faders
+#define KEY_PRESS_MS	80
+#define FADER_MOVE_MS	500 // time of a move over the full range
+
+/**
+ * @brief SimUDP which counts the packets, the messages in them and the intervals
+ *
+ */
+class LoadUDP : public SimUDP {
+
+	public:
+
+		int beginPacket(IPAddress ip, uint16_t port) {
+			packet.clear();
+			return SimUDP::beginPacket(ip, port);
+			}
+
+		// SimUDP writes a buffer also with this
+		size_t write(uint8_t c) {
+			packet.push_back(c);
+			return SimUDP::write(c);
+			}
+
+		using Print::write;
+
+		int endPacket() {
+			uint64_t now = simTime();
+			uint32_t size = packet.size();
+			packets++;
+			bytes += size;
+			messages += countMessages(packet.data(), size);
+			if (size < sizeLow || !sizeLow) sizeLow = size;
+			if (size > sizeHigh) sizeHigh = size;
+			if (last) {
+				double interval = (now - last) / 1000.0;
+				intervals++;
+				intervalSum += interval;
+				intervalSquares += interval * interval;
+				if (interval > intervalHigh) intervalHigh = interval;
+				}
+			last = now;
+			return SimUDP::endPacket();
+			}
+
+		void clear() {
+			packets = bytes = messages = intervals = 0;
+			sizeLow = sizeHigh = 0;
+			intervalSum = intervalSquares = intervalHigh = 0;
+			}
+
+		uint32_t packets = 0;
+		uint32_t bytes = 0;
+		uint32_t messages = 0;
+		uint32_t sizeLow = 0;
+		uint32_t sizeHigh = 0;
+		uint32_t intervals = 0;
+		double intervalSum = 0; // ms
+		double intervalSquares = 0;
+		double intervalHigh = 0;
+
+	private:
+
+		// a bundle counts its elements, nested bundles too
+		static uint32_t countMessages(const uint8_t *data, uint32_t size) {
+			if (size < 16 || memcmp(data, "#bundle", 8) != 0) return 1;
+			uint32_t count = 0;
+			for (uint32_t at = 16; at + 4 <= size;) {
+				uint32_t length = (uint32_t)data[at] << 24 | data[at + 1] << 16 | data[at + 2] << 8 | data[at + 3];
+				at += 4;
+				if (length > size - at) break;
+				count += countMessages(data + at, length);
+				at += length;
+				}
+			return count;
+			}
+
+		std::vector<uint8_t> packet;
+		uint64_t last = 0; // simTime() of the last packet
+
+	};
+
+/**
+ * @brief a virtual box with its socket, controls and the times of the next events
+ *
+ */
+struct Box {
+	LoadUDP udp;
+	EOS *eos;
+	Encoder *encoder;
+	Fader *fader;
+	Key *key;
+	uint8_t pinA;
+	uint8_t pinB;
+	uint8_t pinKey;
+	uint8_t pinFader;
+	uint64_t nextStep;
+	uint64_t encRelease; // A goes HIGH again, 0 while it is HIGH
+	uint64_t nextKey;
+	uint64_t keyRelease;
+	uint64_t nextFader;
+	int16_t level;
+	int16_t target;
+	};
+
+Box boxes[BOXES_MAX];
+uint8_t boxCount = 4;
+IPAddress consoleIP(127, 0, 0, 1);
+uint16_t consolePort = 8000;
+float encRate = 20;
+float faderRate = 1;
+float keyRate = 0.5;
+uint32_t reportMs = 5000;
+
+Box *current; // the box whose init runs
+uint64_t startTime;
+uint64_t reportTime;
+uint64_t lastTick;
+
+void initBox() {
+	filter(*current->eos, "/eos/out/param/*");
+	subscribe(*current->eos, "Pan");
+	initFaders(*current->eos);
+	}
+
+/**
+ * @brief time of the next event of a Poisson process, never with a rate of 0
+ *
+ */
+uint64_t nextEvent(uint64_t now, float rate) {
+	if (rate <= 0) return UINT64_MAX;
+	double u = (random(1, 1000000)) / 1000000.0;
+	return now + (uint64_t)(-log(u) / rate * 1000000);
+	}
+
+void drive(Box &box, uint64_t now, uint32_t elapsed) {
+	// an encoder step is a falling edge of A, B gives the direction
+	if (box.encRelease && now >= box.encRelease) {
+		simDigital(box.pinA, HIGH);
+		box.encRelease = 0;
+		}
+	else if (!box.encRelease && now >= box.nextStep) {
+		simDigital(box.pinB, random(2) ? HIGH : LOW);
+		simDigital(box.pinA, LOW);
+		box.encRelease = now + 1000;
+		box.nextStep = nextEvent(now, encRate);
+		}
+	if (box.keyRelease && now >= box.keyRelease) {
+		simDigital(box.pinKey, HIGH);
+		box.keyRelease = 0;
+		}
+	else if (!box.keyRelease && now >= box.nextKey) {
+		simDigital(box.pinKey, LOW);
+		box.keyRelease = now + KEY_PRESS_MS * 1000;
+		box.nextKey = nextEvent(now, keyRate);
+		}
+	// the fader slides to a new level
+	if (now >= box.nextFader) {
+		box.target = random(1024);
+		box.nextFader = nextEvent(now, faderRate);
+		}
+	int32_t step = (int32_t)elapsed * 1023 / (FADER_MOVE_MS * 1000);
+	if (step < 1) step = 1;
+	if (box.level < box.target) box.level = std::min(box.level + step, (int32_t)box.target);
+	if (box.level > box.target) box.level = std::max(box.level - step, (int32_t)box.target);
+	simAnalog(box.pinFader, box.level);
+	}
+
+void report(uint64_t now) {
+	double seconds = (now - reportTime) / 1000000.0;
+	uint32_t packets = 0, bytes = 0, messages = 0, sizeLow = 0, sizeHigh = 0;
+	for (uint8_t i = 0; i < boxCount; i++) {
+		LoadUDP &udp = boxes[i].udp;
+		packets += udp.packets;
+		bytes += udp.bytes;
+		messages += udp.messages;
+		if (udp.sizeLow && (udp.sizeLow < sizeLow || !sizeLow)) sizeLow = udp.sizeLow;
+		if (udp.sizeHigh > sizeHigh) sizeHigh = udp.sizeHigh;
+		}
+	printf("%.1f s: %u boxes, %.0f messages/s, %.0f packets/s, %.0f bytes/s, packets %u/%.1f/%u bytes\n",
+		(now - startTime) / 1000000.0, boxCount, messages / seconds, packets / seconds, bytes / seconds,
+		sizeLow, packets ? (double)bytes / packets : 0.0, sizeHigh);
+	printf("box  connected  messages/s  packets/s  interval ms  jitter ms  max gap ms\n");
+	for (uint8_t i = 0; i < boxCount; i++) {
+		LoadUDP &udp = boxes[i].udp;
+		double mean = udp.intervals ? udp.intervalSum / udp.intervals : 0;
+		double variance = udp.intervals ? udp.intervalSquares / udp.intervals - mean * mean : 0;
+		printf("%3u  %9s  %10.1f  %9.1f  %11.2f  %9.2f  %10.2f\n", i + 1, boxes[i].eos->connected() ? "yes" : "no",
+			udp.messages / seconds, udp.packets / seconds, mean, sqrt(variance > 0 ? variance : 0), udp.intervalHigh);
+		udp.clear();
+		}
+	fflush(stdout);
+	reportTime = now;
+	}
+
+void setup() {
+	for (uint8_t i = 0; simArg(i); i++) {
+		const char *arg = simArg(i);
+		const char *value = strchr(arg, '=');
+		uint8_t ip[4];
+		if (!value) {
+			fprintf(stderr, "unknown argument %s\n", arg);
+			exit(1);
+			}
+		value++;
+		if (strncmp(arg, "boxes=", 6) == 0) boxCount = std::max(1, std::min(atoi(value), BOXES_MAX));
+		else if (strncmp(arg, "ip=", 3) == 0 && sscanf(value, "%hhu.%hhu.%hhu.%hhu", &ip[0], &ip[1], &ip[2], &ip[3]) == 4) {
+			consoleIP = IPAddress(ip[0], ip[1], ip[2], ip[3]);
+			}
+		else if (strncmp(arg, "port=", 5) == 0) consolePort = atoi(value);
+		else if (strncmp(arg, "enc=", 4) == 0) encRate = atof(value);
+		else if (strncmp(arg, "fader=", 6) == 0) faderRate = atof(value);
+		else if (strncmp(arg, "key=", 4) == 0) keyRate = atof(value);
+		else if (strncmp(arg, "report=", 7) == 0) reportMs = atof(value) * 1000;
+		else {
+			fprintf(stderr, "unknown argument %s\n", arg);
+			exit(1);
+			}
+		}
+	randomSeed(1);
+	uint64_t now = simTime();
+	for (uint8_t i = 0; i < boxCount; i++) {
+		Box &box = boxes[i];
+		box.pinA = 2 + 3 * i;
+		box.pinB = 3 + 3 * i;
+		box.pinKey = 4 + 3 * i;
+		box.pinFader = A0 + i;
+		box.udp.begin(0); // an own port for each box
+		box.eos = new EOS(box.udp, consoleIP, consolePort);
+		box.eos->pingMessage("load_box_" + String(i + 1));
+		box.eos->initHook(initBox);
+		box.encoder = new Encoder(box.pinA, box.pinB);
+		box.encoder->parameter("Pan");
+		box.encoder->bind(*box.eos);
+		box.fader = new Fader(box.pinFader, 0, 0, 1); // no fire and stop buttons
+		box.fader->bind(*box.eos);
+		box.key = new Key(box.pinKey, "GO_0");
+		box.key->bind(*box.eos);
+		box.nextStep = nextEvent(now, encRate);
+		box.nextKey = nextEvent(now, keyRate);
+		box.nextFader = nextEvent(now, faderRate);
+		box.encRelease = box.keyRelease = 0;
+		box.level = box.target = 0;
+		simAnalog(box.pinFader, 0);
+		}
+	startTime = reportTime = lastTick = now;
+	}
+
+void loop() {
+	uint64_t now = simTime();
+	uint32_t elapsed = now - lastTick;
+	lastTick = now;
+	for (uint8_t i = 0; i < boxCount; i++) {
+		Box &box = boxes[i];
+		current = &box;
+		drive(box, now, elapsed);
+		box.eos->update();
+		box.eos->receive(NULL);
+		box.encoder->update();
+		box.fader->update();
+		box.key->update();
+		}
+	if (now - reportTime >= reportMs * 1000ULL) report(now);
+	}
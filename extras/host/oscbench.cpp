@@ -0,0 +1,280 @@
+/*
+Micro-benchmarks of the OSC library for the host build, the hot paths of a box
+with typical Eos messages, each result is the time, the number of allocations
+and the allocated bytes per operation, see extras/host/README.md
+
+usage: ./oscbench [ms=100] [baseline=oscbench.baseline] [save=file] [slower=1.2]
+ms is the time of one round of each benchmark, the fastest of 3 rounds counts,
+with a baseline a benchmark which allocates more or takes more time than slower
+times the time of the baseline is a regression and the exit code is 1
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <OSCMessage.h>
+#include <OSCBundle.h>
+#include <OSCMatch.h>
+#include <time.h>
+#include <vector>
+
+#define BENCH_ROUNDS	3
+
+extern "C" {
+	void *__libc_malloc(size_t size);
+	void *__libc_calloc(size_t count, size_t size);
+	void *__libc_realloc(void *ptr, size_t size);
+
+	static uint64_t allocs;
+	static uint64_t allocBytes;
+
+	// glibc takes these instead of its own, new and delete use them too
+	void *malloc(size_t size) {
+		allocs++;
+		allocBytes += size;
+		return __libc_malloc(size);
+		}
+
+	void *calloc(size_t count, size_t size) {
+		allocs++;
+		allocBytes += count * size;
+		return __libc_calloc(count, size);
+		}
+
+	void *realloc(void *ptr, size_t size) {
+		allocs++;
+		allocBytes += size;
+		return __libc_realloc(ptr, size);
+		}
+	}
+
+/**
+ * @brief encoded packets, the output of send() is kept or thrown away
+ *
+ */
+class BufferPrint : public Print {
+	public:
+		using Print::write;
+		size_t write(uint8_t c) {
+			if (keep) data.push_back(c);
+			size++;
+			return 1;
+			}
+		std::vector<uint8_t> data;
+		bool keep = true;
+		uint32_t size = 0;
+	};
+
+struct Result {
+	std::string name;
+	double ns;
+	double allocs;
+	double bytes;
+	};
+
+std::vector<Result> results;
+uint32_t benchMs = 100;
+float slower = 1.2; // factor of the time which is a regression
+volatile uint32_t sink; // keeps the results of the operations
+
+static uint64_t hostNs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+/**
+ * @brief run an operation until it took benchMs, the count doubles each round,
+ * then the fastest of BENCH_ROUNDS rounds with this count is the result
+ *
+ */
+template <typename F> void bench(const char *name, F operation) {
+	operation(); // warm up, e.g. the first realloc
+	uint64_t count = 1;
+	uint64_t best = 0;
+	uint64_t allocStart = 0, bytesStart = 0;
+	for (uint8_t round = 0; round < BENCH_ROUNDS;) {
+		allocStart = allocs;
+		bytesStart = allocBytes;
+		uint64_t start = hostNs();
+		for (uint64_t i = 0; i < count; i++) operation();
+		uint64_t time = hostNs() - start;
+		if (!round && time < benchMs * 1000000ULL) {
+			count *= 2;
+			continue;
+			}
+		if (!round || time < best) best = time;
+		round++;
+		}
+	Result result = {name, (double)best / count, (double)(allocs - allocStart) / count,
+		(double)(allocBytes - bytesStart) / count};
+	results.push_back(result);
+	printf("%-24s %10.1f ns/op %8.2f allocs/op %8.1f bytes/op\n", name, result.ns, result.allocs, result.bytes);
+	fflush(stdout);
+	}
+
+std::vector<uint8_t> encode(OSCMessage &msg) {
+	BufferPrint out;
+	msg.send(out);
+	return out.data;
+	}
+
+void parseParam(OSCMessage &msg, int offset) {
+	sink += msg.getFloat(0);
+	}
+
+bool loadBaseline(const char *path, std::vector<Result> &baseline) {
+	FILE *file = fopen(path, "r");
+	if (!file) return false;
+	char line[128], name[64];
+	Result result;
+	while (fgets(line, sizeof(line), file)) {
+		if (line[0] == '#') continue;
+		if (sscanf(line, "%63s %lf %lf %lf", name, &result.ns, &result.allocs, &result.bytes) != 4) continue;
+		result.name = name;
+		baseline.push_back(result);
+		}
+	fclose(file);
+	return true;
+	}
+
+bool saveResults(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (!file) return false;
+	fprintf(file, "# oscbench of extras/host, name ns/op allocs/op bytes/op\n");
+	for (size_t i = 0; i < results.size(); i++) {
+		Result &result = results[i];
+		fprintf(file, "%s %.1f %.2f %.1f\n", result.name.c_str(), result.ns, result.allocs, result.bytes);
+		}
+	fclose(file);
+	return true;
+	}
+
+// compare with the baseline, the time only gives a hint on another host
+uint8_t compare(std::vector<Result> &baseline) {
+	uint8_t regressions = 0;
+	printf("\n%-24s %10s %10s %12s\n", "compared to baseline", "time", "allocs/op", "bytes/op");
+	for (size_t i = 0; i < results.size(); i++) {
+		Result &result = results[i];
+		for (size_t j = 0; j < baseline.size(); j++) {
+			Result &base = baseline[j];
+			if (base.name != result.name) continue;
+			bool slow = result.ns > base.ns * slower;
+			bool more = result.allocs > base.allocs + 0.005 || result.bytes > base.bytes + 0.05;
+			printf("%-24s %+9.0f%% %+10.2f %+12.1f%s\n", result.name.c_str(), (result.ns / base.ns - 1) * 100,
+				result.allocs - base.allocs, result.bytes - base.bytes, slow || more ? "  regression" : "");
+			if (slow || more) regressions++;
+			}
+		}
+	return regressions;
+	}
+
+void setup() {
+	const char *baselinePath = NULL;
+	const char *savePath = NULL;
+	for (uint8_t i = 0; simArg(i); i++) {
+		if (strncmp(simArg(i), "ms=", 3) == 0) benchMs = atoi(simArg(i) + 3);
+		else if (strncmp(simArg(i), "baseline=", 9) == 0) baselinePath = simArg(i) + 9;
+		else if (strncmp(simArg(i), "save=", 5) == 0) savePath = simArg(i) + 5;
+		else if (strncmp(simArg(i), "slower=", 7) == 0) slower = atof(simArg(i) + 7);
+		else {
+			fprintf(stderr, "usage: ./oscbench [ms=100] [baseline=file] [save=file] [slower=1.2]\n");
+			exit(1);
+			}
+		}
+
+	// the messages of a box and of Eos
+	OSCMessage wheel("/eos/wheel/coarse/pan");
+	wheel.add(1.0f);
+	OSCMessage param("/eos/out/param/Pan");
+	param.add(12.5f);
+	param.add(0.0f);
+	OSCMessage cue("/eos/out/active/cue/text");
+	cue.add("1/2 Cue 2 5.0 100%");
+	std::vector<uint8_t> paramPacket = encode(param);
+	std::vector<uint8_t> cuePacket = encode(cue);
+	OSCBundle init;
+	init.add("/eos/filter/add").add("/eos/out/param/*");
+	init.add("/eos/subscribe/param/Pan").add((int32_t)1);
+	init.add("/eos/fader/1/config/1/10");
+	BufferPrint bundleOut;
+	init.send(bundleOut);
+	std::vector<uint8_t> bundlePacket = bundleOut.data;
+	BufferPrint out;
+	out.keep = false;
+	char text[64];
+	uint8_t blob[32] = {};
+
+	bench("message_add", [&]() {
+		OSCMessage msg("/eos/wheel/coarse/pan");
+		msg.add(1.0f);
+		msg.add((int32_t)1);
+		msg.add("text");
+		sink += msg.size();
+		});
+	bench("message_send", [&]() {
+		wheel.send(out);
+		});
+	bench("message_fill_float", [&]() {
+		OSCMessage msg;
+		msg.fill(paramPacket.data(), paramPacket.size());
+		sink += msg.getFloat(0);
+		});
+	bench("message_fill_string", [&]() {
+		OSCMessage msg;
+		msg.fill(cuePacket.data(), cuePacket.size());
+		sink += msg.getString(0, text, sizeof(text));
+		});
+	bench("bundle_encode", [&]() {
+		OSCBundle bundle;
+		bundle.add("/eos/filter/add").add("/eos/out/param/*");
+		bundle.add("/eos/subscribe/param/Pan").add((int32_t)1);
+		bundle.add("/eos/fader/1/config/1/10");
+		bundle.send(out);
+		});
+	bench("bundle_send", [&]() {
+		init.send(out);
+		});
+	bench("bundle_decode", [&]() {
+		OSCBundle bundle;
+		bundle.fill(bundlePacket.data(), bundlePacket.size());
+		sink += bundle.size();
+		});
+	bench("match_full", [&]() {
+		sink += param.fullMatch("/eos/out/param/Pan");
+		});
+	bench("match_route", [&]() {
+		sink += param.route("/eos/out/param", parseParam);
+		});
+	bench("osc_match_wildcard", [&]() {
+		int patternOffset, addressOffset;
+		sink += osc_match("/eos/out/param/*", "/eos/out/param/Pan", &patternOffset, &addressOffset);
+		});
+	bench("data_string", [&]() {
+		OSCData data("1/2 Cue 2 5.0 100%");
+		sink += data.getString(text, sizeof(text));
+		});
+	bench("data_blob", [&]() {
+		OSCData data(blob, sizeof(blob));
+		sink += data.getBlob(blob, sizeof(blob));
+		});
+
+	uint8_t regressions = 0;
+	if (baselinePath) {
+		std::vector<Result> baseline;
+		if (!loadBaseline(baselinePath, baseline)) {
+			fprintf(stderr, "can't load %s\n", baselinePath);
+			exit(1);
+			}
+		regressions = compare(baseline);
+		}
+	if (savePath && !saveResults(savePath)) {
+		fprintf(stderr, "can't save %s\n", savePath);
+		exit(1);
+		}
+	exit(regressions ? 1 : 0);
+	}
+
+void loop() {
+	}
@@ -0,0 +1,202 @@
+/*
+Replay of a capture of eOS for the host build, the received packets are fed
+into the library at the original speed or as fast as possible and each message
+is printed, so the output of two versions of the parsing can be compared,
+the packets per second give the decode throughput, see extras/host/README.md
+
+usage: ./replay [options of the host build] capture [fast] [quiet]
+fast ignores the timestamps, quiet doesn't print the messages
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <OSCMessage.h>
+#include "eOS.h"
+#include <time.h>
+#include <vector>
+
+/**
+ * @brief UDP which gives the received packets of a capture to the library
+ * and throws the sent packets away
+ *
+ */
+class ReplayUDP : public UDP {
+
+	public:
+
+		bool load(const char *path) {
+			FILE *file = fopen(path, "rb");
+			if (!file) return false;
+			uint8_t buffer[7];
+			uint64_t time = 0;
+			uint32_t last = 0;
+			bool first = true;
+			size_t got = fread(buffer, 1, 4, file);
+			if (got == 4 && memcmp(buffer, "eOS\x01", 4) != 0) fseek(file, 0, SEEK_SET); // a dump over UDP has no header
+			while (fread(buffer, 1, 7, file) == 7) {
+				Record record;
+				uint32_t micros = buffer[0] | buffer[1] << 8 | buffer[2] << 16 | (uint32_t)buffer[3] << 24;
+				if (!first) time += (uint32_t)(micros - last); // micros() can overflow in the capture
+				first = false;
+				last = micros;
+				record.time = time;
+				record.flags = buffer[6];
+				record.data.resize(buffer[4] | buffer[5] << 8);
+				if (fread(record.data.data(), 1, record.data.size(), file) != record.data.size()) break;
+				if (record.flags & EOS_CAPTURE_TX) txCaptured++;
+				else records.push_back(record);
+				}
+			fclose(file);
+			return true;
+			}
+
+		// one batch in fast mode, so the receive ring of eOS doesn't overflow
+		void next() {
+			batch = 0;
+			}
+
+		bool done() {
+			return pos == records.size();
+			}
+
+		uint8_t begin(uint16_t port) {return 1;}
+		void stop() {}
+		int beginPacket(IPAddress ip, uint16_t port) {return 1;}
+		int beginPacket(const char *host, uint16_t port) {return 1;}
+		int endPacket() {
+			txPackets++;
+			return 1;
+			}
+		size_t write(uint8_t c) {return 1;}
+		size_t write(const uint8_t *buffer, size_t size) {return size;}
+		using Print::write;
+
+		int parsePacket() {
+			if (done()) return 0;
+			if (fast && batch == EOS_RX_SLOTS) return 0;
+			if (!fast && records[pos].time > simTime() - start) return 0;
+			packet = &records[pos++];
+			readPos = 0;
+			batch++;
+			rxBytes += packet->data.size();
+			return packet->data.size();
+			}
+
+		int available() {
+			return packet ? packet->data.size() - readPos : 0;
+			}
+
+		int read() {
+			return available() ? packet->data[readPos++] : -1;
+			}
+
+		int read(unsigned char *buffer, size_t size) {
+			size_t n = available();
+			if (n > size) n = size;
+			if (n) memcpy(buffer, packet->data.data() + readPos, n);
+			readPos += n;
+			return n;
+			}
+
+		int read(char *buffer, size_t size) {
+			return read((unsigned char*)buffer, size);
+			}
+
+		int peek() {
+			return available() ? packet->data[readPos] : -1;
+			}
+
+		void flush() {
+			if (packet) readPos = packet->data.size();
+			}
+
+		IPAddress remoteIP() {return IPAddress(127, 0, 0, 1);}
+		uint16_t remotePort() {return 8000;}
+
+		bool fast = false;
+		uint64_t start = 0; // simTime() of the first record
+		uint32_t rxBytes = 0;
+		uint32_t txPackets = 0;
+		uint32_t txCaptured = 0;
+		size_t count() {return records.size();}
+
+	private:
+
+		struct Record {
+			uint64_t time; // us from the first record
+			uint8_t flags;
+			std::vector<uint8_t> data;
+			};
+
+		std::vector<Record> records;
+		size_t pos = 0;
+		Record *packet = NULL;
+		size_t readPos = 0;
+		uint8_t batch = 0;
+
+	};
+
+ReplayUDP udp;
+EOS eos(udp, IPAddress(127, 0, 0, 1), 8000);
+
+bool quiet = false;
+uint32_t messages = 0;
+uint64_t hostStart;
+
+static uint64_t hostUs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+
+void printMessage(OSCMessage& msg) {
+	messages++;
+	if (quiet) return;
+	char text[256];
+	msg.getAddress(text);
+	printf("%s", text);
+	for (int i = 0; i < msg.size(); i++) {
+		switch (msg.getType(i)) {
+			case 'i': printf(" %d", (int)msg.getInt(i)); break;
+			case 'f': printf(" %g", msg.getFloat(i)); break;
+			case 's':
+				msg.getString(i, text, sizeof(text));
+				printf(" \"%s\"", text);
+				break;
+			case 'b': printf(" <%d bytes>", msg.getBlobLength(i)); break;
+			default: printf(" %c", msg.getType(i));
+			}
+		}
+	printf("\n");
+	}
+
+void setup() {
+	const char *path = simArg(0);
+	for (uint8_t i = 1; simArg(i); i++) {
+		if (strcmp(simArg(i), "fast") == 0) udp.fast = true;
+		if (strcmp(simArg(i), "quiet") == 0) quiet = true;
+		}
+	if (!path || !udp.load(path)) {
+		fprintf(stderr, "usage: ./replay [options] capture [fast] [quiet]\n");
+		exit(1);
+		}
+	udp.start = simTime();
+	hostStart = hostUs();
+	}
+
+void loop() {
+	udp.next();
+	eos.receive(printMessage);
+	if (!udp.done()) return;
+	fflush(stdout);
+	uint64_t hostTime = hostUs() - hostStart;
+	if (!hostTime) hostTime = 1;
+	fprintf(stderr, "%u packets, %u bytes, %u messages, %u dropped, %u sent packets skipped, %u sent by the replay\n",
+		(unsigned)udp.count(), (unsigned)udp.rxBytes, (unsigned)messages, (unsigned)eos.rxDropped(),
+		(unsigned)udp.txCaptured, (unsigned)udp.txPackets);
+	fprintf(stderr, "%.3f ms on the host, %.0f packets/s, %.2f MB/s\n", hostTime / 1000.0,
+		udp.count() * 1e6 / hostTime, udp.rxBytes / (double)hostTime);
+	exit(0);
+	}
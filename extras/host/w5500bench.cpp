@@ -0,0 +1,158 @@
+/*
+SPI benchmark of the W5500 driver of Ethernet3 on the simulated W5500, for each operation the
+SPI transactions (CS cycles), the bytes and the bus cycles of the SPI clock are counted and
+compared with the expected counts, see extras/host/README.md
+- a packet written with 8 write() calls like the OSC library does, with and without burst write
+- the Rx status of a socket with the single 16 bit registers and with the status block
+- parsePacket() without a packet and with a packet and its read()
+
+usage: ./w5500bench [packets=100] [clock=8000000]
+clock is the SPI clock for the bus time, the exit code is 1 if a count differs from the expected
+one or the statistics of the driver (W5500_SPI_STATS) differ from the bus of the simulation
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include "Arduino.h"
+#include <Ethernet3.h>
+
+#define BENCH_PORT_TX	9000
+#define BENCH_PORT_RX	9001
+#define BENCH_SIZE		32 // bytes of a packet
+#define BENCH_WRITES		8 // write() calls of a packet
+
+struct Bench {
+	const char *name;
+	uint32_t transactions; // expected per operation
+	uint32_t bytes;
+	};
+
+// the counts of the driver, a change of the driver which adds transactions shows up here
+static const Bench expected[] = {
+	{"send, byte writes", 45, 241},
+	{"send, burst write", 9, 95},
+	{"rx status, registers", 3, 15},
+	{"rx status, block", 2, 30},
+	{"parsePacket, empty", 2, 30},
+	{"parsePacket and read", 13, 117},
+	};
+
+static uint8_t mac[] = {0x90, 0xA2, 0xDA, 0x10, 0x14, 0x48};
+static EthernetUDP tx;
+static EthernetUDP rx;
+static uint32_t packets = 100;
+static uint32_t clock = W5500_SPI_CLOCK;
+static uint8_t failures = 0;
+
+static void sendPacket() {
+	uint8_t data[BENCH_SIZE];
+	for (uint8_t i = 0; i < BENCH_SIZE; i++) data[i] = i;
+	tx.beginPacket(IPAddress(127, 0, 0, 1), BENCH_PORT_RX);
+	for (uint8_t i = 0; i < BENCH_WRITES; i++) tx.write(data + i * (BENCH_SIZE / BENCH_WRITES), BENCH_SIZE / BENCH_WRITES);
+	tx.endPacket();
+	}
+
+static void start() {
+	simSpiReset();
+	W5500Class::resetSpiStats();
+	}
+
+static bool driverMatch() {
+	return simSpiTransactions() == W5500Class::spiTransactions && simSpiBytes() == W5500Class::spiBytes;
+	}
+
+static void result(uint8_t index, uint32_t totalTransactions, uint32_t totalBytes, bool driver) {
+	const Bench &bench = expected[index];
+	double transactions = (double)totalTransactions / packets;
+	double bytes = (double)totalBytes / packets;
+	// a byte takes 8 cycles, the bus is idle for about a cycle at each CS edge
+	double us = (bytes * 8 + transactions * 2) * 1e6 / clock;
+	bool match = transactions == bench.transactions && bytes == bench.bytes;
+	printf("%-22s %8.1f %8.1f %8.0f %8.2f%s%s\n", bench.name, transactions, bytes, bytes * 8, us,
+		match ? "" : "  expected", driver ? "" : "  driver stats differ");
+	if (!match) {
+		printf("%-22s %8u %8u\n", "", bench.transactions, bench.bytes);
+		failures++;
+		}
+	if (!driver) failures++;
+	}
+
+static void result(uint8_t index) {
+	result(index, simSpiTransactions(), simSpiBytes(), driverMatch());
+	}
+
+void setup() {
+	for (uint8_t i = 0; simArg(i); i++) {
+		if (strncmp(simArg(i), "packets=", 8) == 0) packets = atoi(simArg(i) + 8);
+		else if (strncmp(simArg(i), "clock=", 6) == 0) clock = atoi(simArg(i) + 6);
+		else {
+			fprintf(stderr, "unknown argument %s\n", simArg(i));
+			exit(1);
+			}
+		}
+	if (packets == 0) packets = 1;
+	Ethernet.begin(mac, IPAddress(127, 0, 0, 1));
+	tx.begin(BENCH_PORT_TX);
+	rx.begin(BENCH_PORT_RX);
+	uint8_t s = 1; // rx, the sockets are taken in the order of begin()
+	printf("%-22s %8s %8s %8s %8s\n", "per operation", "trans", "bytes", "cycles", "us");
+
+	start();
+	for (uint32_t n = 0; n < packets; n++) sendPacket();
+	result(0);
+	while (rx.parsePacket() > 0);
+
+	tx.setBurstWrite(true);
+	start();
+	for (uint32_t n = 0; n < packets; n++) sendPacket();
+	result(1);
+	while (rx.parsePacket() > 0);
+
+	start();
+	for (uint32_t n = 0; n < packets; n++) {
+		w5500.getRXReceivedSize(s);
+		w5500.readSnRX_RD(s);
+		}
+	result(2);
+
+	start();
+	for (uint32_t n = 0; n < packets; n++) {
+		W5500Class::SnStatus status;
+		w5500.readSnStatus(s, &status);
+		}
+	result(3);
+
+	start();
+	for (uint32_t n = 0; n < packets; n++) rx.parsePacket();
+	result(4);
+
+	// a packet is sent before each count, one is read at a time like in the loop of a box
+	uint8_t data[BENCH_SIZE];
+	uint32_t transactions = 0;
+	uint32_t bytes = 0;
+	bool driver = true;
+	for (uint32_t n = 0; n < packets; n++) {
+		sendPacket();
+		start();
+		if (rx.parsePacket() != BENCH_SIZE || rx.read(data, BENCH_SIZE) != BENCH_SIZE || data[BENCH_SIZE - 1] != BENCH_SIZE - 1) {
+			printf("packet %u not received\n", n);
+			failures++;
+			break;
+			}
+		transactions += simSpiTransactions();
+		bytes += simSpiBytes();
+		driver = driver && driverMatch();
+		}
+	result(5, transactions, bytes, driver);
+
+	// the status block clocks more bytes, but the pointers and the Tx status come with it
+	printf("burst write per packet: %+d transactions, %+d bytes\n",
+		(int)(expected[1].transactions - expected[0].transactions), (int)(expected[1].bytes - expected[0].bytes));
+	printf("status block per status read: %+d transactions, %+d bytes\n",
+		(int)(expected[3].transactions - expected[2].transactions), (int)(expected[3].bytes - expected[2].bytes));
+	exit(failures ? 1 : 0);
+	}
+
+void loop() {
+	}
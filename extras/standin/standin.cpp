@@ -0,0 +1,763 @@
+/*
+Stand-in for an EOS console to test the eOS library on Linux without a console.
+It speaks the OSC dialect of EOS which is used by the boxes:
+- /eos/ping is answered with /eos/out/ping and the same arguments, also broadcast pings of the discovery
+- /eos/filter/add, /eos/subscribe/param/<param> and /eos/fader/<bank>/config/<page>/<faders> are kept for each box
+- /eos/wheel/<param> changes the parameter, the new value is sent to the boxes which subscribed it
+- /eos/key/GO_0 starts the pending cue
+- /eos/out/param/<param> and /eos/out/active|pending/cue/text are sent as streams with a given rate
+It listens on UDP, on TCP with OSC 1.0 packet length framing, on TCP with OSC 1.1 SLIP
+framing and optional on a serial port with SLIP like a USB box, e.g. the pty of extras/host.
+With -d it is also a DHCP server, so the lease and the renew of Ethernet3 can be tested,
+with the simulated W5500 of extras/host on port 10067 or with a board on port 67 as root.
+Each received message is logged to stdout with a timestamp in us of the system clock,
+so the time can be compared with the log of a box, the messages and bytes per second of
+each transport are printed to stderr.
+
+build: g++ -O2 -o standin standin.cpp
+usage: ./standin [-q] [-p Hz] [-c Hz] [-s serial] [-d port] [-l s] [udp port] [tcp length port] [tcp slip port]
+-q doesn't log the messages
+-p rate of the /eos/out/param stream for each subscribed parameter, standard 0 (off)
+-c rate of the /eos/out/active/cue/text stream, standard 0 (off)
+-s serial port of a USB box
+-d port of the DHCP server, standard off, a box gets .101, .102 ... of the subnet of the
+   address on which its request came in, the stand-in is the gateway and the DNS server
+-l lease time of the DHCP server in s, standard 60, short times test the renew
+the standard ports are 8000, 3032 and 3037 like EOS
+
+eOS library is placed under the MIT license
+Copyright (c) 2020 Stefan Staub
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <math.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <termios.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define BOXES_MAX			16
+#define PACKET_MAX		4096
+#define FILTERS_MAX		16
+#define PARAMS_MAX		16
+#define NAME_MAX			64
+#define ARGS_MAX			8
+#define UDP_TIMEOUT_MS	10000 // a UDP box is forgotten after this idle time
+#define LEASES_MAX		16 // boxes with a DHCP lease
+
+static const uint8_t eot = 0300;
+static const uint8_t slipesc = 0333;
+static const uint8_t slipescend = 0334;
+static const uint8_t slipescesc = 0335;
+
+enum transport_t {UDP, TCP_LENGTH, TCP_SLIP, SERIAL_SLIP};
+const char *transportName[] = {"udp", "tcp length", "tcp slip", "serial"};
+
+struct Stats {
+	uint32_t packets;
+	uint32_t bytes;
+	uint32_t sent; // messages to the boxes
+	} stats[4];
+
+/**
+ * @brief a box with its framing and the console state, filters, subscriptions and faders
+ *
+ */
+struct Box {
+	bool used;
+	transport_t transport;
+	int fd; // TCP socket or serial port, UDP uses the common socket
+	sockaddr_in remote;
+	char name[32];
+	uint64_t rxTime; // ms
+	uint8_t packet[PACKET_MAX];
+	uint32_t fill;
+	uint32_t length; // packet length of TCP_LENGTH
+	uint8_t header; // received bytes of the packet length
+	bool escape;
+	bool handshake; // serial, OK was received
+	char filters[FILTERS_MAX][NAME_MAX];
+	uint8_t filterCount;
+	char params[PARAMS_MAX][NAME_MAX];
+	uint8_t paramCount;
+	uint8_t faderBank;
+	uint8_t faderPage;
+	uint8_t faderCount;
+	} boxes[BOXES_MAX];
+
+/**
+ * @brief a parameter of the console, changed by the wheels
+ *
+ */
+struct Param {
+	char name[NAME_MAX];
+	float value;
+	float min;
+	float max;
+	} params[PARAMS_MAX] = {
+	{"intens", 0, 0, 100}, {"pan", 0, -270, 270}, {"tilt", 0, -135, 135}, {"zoom", 20, 5, 60},
+	{"edge", 50, 0, 100}, {"iris", 100, 0, 100}, {"red", 100, 0, 100}, {"green", 100, 0, 100}, {"blue", 100, 0, 100}
+	};
+uint8_t paramCount = 9;
+
+struct OSCArg {
+	char type;
+	int32_t i;
+	float f;
+	const char *s;
+	};
+
+/**
+ * @brief the MAC address of a box with a DHCP lease, the index is the address of the box
+ *
+ */
+struct Lease {
+	bool used;
+	uint8_t mac[6];
+	} leases[LEASES_MAX];
+
+int udpSock;
+int dhcpSock = -1;
+uint32_t leaseTime = 60;
+bool quiet = false;
+float paramRate = 0;
+float cueRate = 0;
+uint16_t activeCue = 1;
+float cuePercent = 100;
+
+uint64_t nowMs() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+	}
+
+/**
+ * @brief log a line with the time of the system clock in us, comparable with other programs
+ *
+ */
+void logLine(const char *format, ...) {
+	if (quiet) return;
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	printf("%lu.%06lu ", (unsigned long)ts.tv_sec, (unsigned long)ts.tv_nsec / 1000);
+	va_list args;
+	va_start(args, format);
+	vprintf(format, args);
+	va_end(args);
+	putchar('\n');
+	}
+
+/**
+ * @brief size of an OSC string with the terminating zero, padded to 4 bytes
+ *
+ */
+size_t oscStringSize(const uint8_t *data, size_t size) {
+	size_t len = strnlen((const char*)data, size);
+	if (len == size) return 0; // not terminated
+	return (len + 4) & ~3;
+	}
+
+uint32_t oscInt(const uint8_t *data) {
+	return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3];
+	}
+
+void oscPutInt(uint8_t *data, uint32_t v) {
+	for (int i = 0; i < 4; i++) data[i] = v >> (24 - 8 * i);
+	}
+
+size_t oscPutString(uint8_t *out, const char *s) {
+	size_t len = strlen(s) + 1;
+	size_t size = (len + 3) & ~3;
+	memcpy(out, s, len);
+	memset(out + len, 0, size - len);
+	return size;
+	}
+
+/**
+ * @brief build an OSC message, the arguments are given by the type tags i, f and s
+ *
+ * @return size_t size of the message
+ */
+size_t oscBuild(uint8_t *out, const char *address, const char *tags, ...) {
+	char tagString[ARGS_MAX + 2];
+	snprintf(tagString, sizeof(tagString), ",%s", tags);
+	size_t n = oscPutString(out, address);
+	n += oscPutString(out + n, tagString);
+	va_list args;
+	va_start(args, tags);
+	for (const char *t = tags; *t; t++) {
+		if (*t == 'i') {
+			oscPutInt(out + n, va_arg(args, int));
+			n += 4;
+			}
+		else if (*t == 'f') {
+			float f = va_arg(args, double);
+			uint32_t v;
+			memcpy(&v, &f, 4);
+			oscPutInt(out + n, v);
+			n += 4;
+			}
+		else if (*t == 's') n += oscPutString(out + n, va_arg(args, const char*));
+		}
+	va_end(args);
+	return n;
+	}
+
+/**
+ * @brief send a packet to a box in the framing of its transport
+ *
+ */
+void boxSend(Box &box, const uint8_t *packet, size_t size) {
+	stats[box.transport].sent++;
+	if (box.transport == UDP) {
+		sendto(udpSock, packet, size, 0, (sockaddr*)&box.remote, sizeof(box.remote));
+		return;
+		}
+	uint8_t frame[2 * PACKET_MAX + 4];
+	size_t n = 0;
+	if (box.transport == TCP_LENGTH) {
+		oscPutInt(frame, size);
+		n = 4;
+		memcpy(frame + n, packet, size);
+		n += size;
+		}
+	else {
+		frame[n++] = eot;
+		for (size_t i = 0; i < size; i++) {
+			if (packet[i] == eot || packet[i] == slipesc) {
+				frame[n++] = slipesc;
+				frame[n++] = packet[i] == eot ? slipescend : slipescesc;
+				}
+			else frame[n++] = packet[i];
+			}
+		frame[n++] = eot;
+		}
+	if (box.transport == SERIAL_SLIP) {
+		if (write(box.fd, frame, n) < 0) {} // a full port loses the data like a console
+		}
+	else send(box.fd, frame, n, MSG_NOSIGNAL);
+	}
+
+/**
+ * @brief send a message from the console if it passes the filters of the box,
+ * without filters EOS sends everything
+ *
+ */
+void boxOut(Box &box, const uint8_t *packet, size_t size) {
+	if (box.filterCount) {
+		bool pass = false;
+		for (uint8_t i = 0; i < box.filterCount && !pass; i++) {
+			pass = fnmatch(box.filters[i], (const char*)packet, 0) == 0;
+			}
+		if (!pass) return;
+		}
+	boxSend(box, packet, size);
+	}
+
+Param *findParam(const char *name) {
+	for (uint8_t i = 0; i < paramCount; i++) {
+		if (strcasecmp(params[i].name, name) == 0) return &params[i];
+		}
+	if (paramCount == PARAMS_MAX) return NULL;
+	Param &param = params[paramCount++];
+	snprintf(param.name, NAME_MAX, "%s", name);
+	param.value = 0;
+	param.min = 0;
+	param.max = 100;
+	return &param;
+	}
+
+/**
+ * @brief the name of a parameter like the box subscribed it
+ *
+ * @return const char* NULL if the box didn't subscribe it
+ */
+const char *subscribed(Box &box, const char *name) {
+	for (uint8_t i = 0; i < box.paramCount; i++) {
+		if (strcasecmp(box.params[i], name) == 0) return box.params[i];
+		}
+	return NULL;
+	}
+
+/**
+ * @brief send a parameter to all boxes which subscribed it
+ *
+ */
+void paramOut(Param &param, float value) {
+	uint8_t packet[512];
+	char address[2 * NAME_MAX];
+	for (int i = 0; i < BOXES_MAX; i++) {
+		const char *name = boxes[i].used ? subscribed(boxes[i], param.name) : NULL;
+		if (!name) continue;
+		snprintf(address, sizeof(address), "/eos/out/param/%s", name);
+		boxOut(boxes[i], packet, oscBuild(packet, address, "f", value));
+		}
+	}
+
+/**
+ * @brief send the text of the active and the pending cue to all boxes
+ *
+ */
+void cueOut() {
+	uint8_t packet[512];
+	char text[64];
+	snprintf(text, sizeof(text), "1/%u Cue %u 5.0 %.0f%%", activeCue, activeCue, cuePercent);
+	size_t active = oscBuild(packet, "/eos/out/active/cue/text", "s", text);
+	for (int i = 0; i < BOXES_MAX; i++) {
+		if (boxes[i].used) boxOut(boxes[i], packet, active);
+		}
+	snprintf(text, sizeof(text), "1/%u Cue %u 5.0", activeCue + 1, activeCue + 1);
+	size_t pending = oscBuild(packet, "/eos/out/pending/cue/text", "s", text);
+	for (int i = 0; i < BOXES_MAX; i++) {
+		if (boxes[i].used) boxOut(boxes[i], packet, pending);
+		}
+	}
+
+/**
+ * @brief the reaction of the console on a message of a box
+ *
+ */
+void console(Box &box, const char *address, const OSCArg *args, uint8_t argc, const uint8_t *packet, size_t size) {
+	uint8_t bank, page, faders;
+	if (strcmp(address, "/eos/ping") == 0) {
+		// the same type tags and arguments with the new address
+		static const char reply[] = "/eos/out/ping\0\0"; // padded to 16 bytes
+		uint8_t out[PACKET_MAX + 16];
+		size_t addrSize = oscStringSize(packet, size);
+		memcpy(out, reply, 16);
+		memcpy(out + 16, packet + addrSize, size - addrSize);
+		boxSend(box, out, 16 + size - addrSize);
+		}
+	else if (strcmp(address, "/eos/filter/add") == 0) {
+		for (uint8_t i = 0; i < argc && box.filterCount < FILTERS_MAX; i++) {
+			if (args[i].type == 's') snprintf(box.filters[box.filterCount++], NAME_MAX, "%s", args[i].s);
+			}
+		}
+	else if (strcmp(address, "/eos/filter/remove") == 0 || strcmp(address, "/eos/filter/clear") == 0) {
+		box.filterCount = 0;
+		}
+	else if (strncmp(address, "/eos/subscribe/param/", 21) == 0) {
+		const char *name = address + 21;
+		bool on = argc == 0 || (args[0].type == 'i' ? args[0].i : args[0].f) != 0;
+		for (uint8_t i = 0; i < box.paramCount; i++) {
+			if (strcasecmp(box.params[i], name) == 0) {
+				if (!on) memmove(box.params[i], box.params[i + 1], (--box.paramCount - i) * NAME_MAX);
+				on = false;
+				break;
+				}
+			}
+		if (on && box.paramCount < PARAMS_MAX) {
+			snprintf(box.params[box.paramCount++], NAME_MAX, "%s", name);
+			Param *param = findParam(name);
+			if (param) paramOut(*param, param->value); // EOS sends the value at once
+			}
+		}
+	else if (sscanf(address, "/eos/fader/%hhu/config/%hhu/%hhu", &bank, &page, &faders) == 3) {
+		box.faderBank = bank;
+		box.faderPage = page;
+		box.faderCount = faders;
+		}
+	else if (strncmp(address, "/eos/wheel/", 11) == 0 && argc && args[0].type == 'f') {
+		const char *tail = address + 11;
+		float scale = 1;
+		if (strncmp(tail, "fine/", 5) == 0) {
+			tail += 5;
+			scale = 0.1;
+			}
+		else if (strncmp(tail, "coarse/", 7) == 0) tail += 7;
+		Param *param = findParam(tail);
+		if (param) {
+			param->value += args[0].f * scale;
+			if (param->value < param->min) param->value = param->min;
+			if (param->value > param->max) param->value = param->max;
+			paramOut(*param, param->value);
+			}
+		}
+	else if (strcmp(address, "/eos/key/GO_0") == 0 && argc && args[0].type == 'i' && args[0].i) {
+		activeCue++;
+		cuePercent = 0;
+		cueOut();
+		}
+	}
+
+/**
+ * @brief parse a message or a bundle, log and answer each message
+ *
+ */
+void oscPacket(Box &box, const uint8_t *packet, size_t size) {
+	if (size >= 16 && memcmp(packet, "#bundle", 8) == 0) {
+		size_t n = 16;
+		while (n + 4 <= size) {
+			uint32_t element = oscInt(packet + n);
+			n += 4;
+			if (element > size - n) break;
+			oscPacket(box, packet + n, element);
+			n += element;
+			}
+		return;
+		}
+	size_t addrSize = oscStringSize(packet, size);
+	if (addrSize == 0 || addrSize >= size || packet[addrSize] != ',') return; // no OSC message
+	const char *address = (const char*)packet;
+	const uint8_t *tags = packet + addrSize;
+	size_t tagSize = oscStringSize(tags, size - addrSize);
+	if (tagSize == 0) return;
+	const uint8_t *data = tags + tagSize;
+	const uint8_t *end = packet + size;
+	OSCArg args[ARGS_MAX];
+	uint8_t argc = 0;
+	char text[256];
+	int len = snprintf(text, sizeof(text), "%s", address);
+	for (const uint8_t *t = tags + 1; *t && argc < ARGS_MAX; t++) {
+		OSCArg &arg = args[argc];
+		arg.type = *t;
+		if ((*t == 'i' || *t == 'f') && data + 4 <= end) {
+			uint32_t v = oscInt(data);
+			arg.i = v;
+			memcpy(&arg.f, &v, 4);
+			data += 4;
+			if (*t == 'i') len += snprintf(text + len, sizeof(text) - len, " %d", arg.i);
+			else len += snprintf(text + len, sizeof(text) - len, " %f", arg.f);
+			}
+		else if (*t == 's' && data < end) {
+			size_t stringSize = oscStringSize(data, end - data);
+			if (stringSize == 0) break;
+			arg.s = (const char*)data;
+			data += stringSize;
+			len += snprintf(text + len, sizeof(text) - len, " \"%s\"", arg.s);
+			}
+		else break;
+		argc++;
+		if (len >= (int)sizeof(text)) len = sizeof(text) - 1;
+		}
+	logLine("%s %s %s", transportName[box.transport], box.name, text);
+	console(box, address, args, argc, packet, size);
+	}
+
+/**
+ * @brief count a received packet, the serial port has the handshake of EOS before the OSC
+ *
+ */
+void received(Box &box, const uint8_t *packet, size_t size) {
+	stats[box.transport].packets++;
+	stats[box.transport].bytes += size;
+	box.rxTime = nowMs();
+	if (box.transport == SERIAL_SLIP && !box.handshake) {
+		if (size == 2 && memcmp(packet, "OK", 2) == 0) {
+			box.handshake = true;
+			logLine("serial %s handshake", box.name);
+			}
+		return;
+		}
+	oscPacket(box, packet, size);
+	}
+
+/**
+ * @brief decode the stream of a TCP or serial box, a packet can be split over reads
+ *
+ */
+void streamReceive(Box &box, const uint8_t *data, size_t size) {
+	for (size_t i = 0; i < size; i++) {
+		uint8_t c = data[i];
+		if (box.transport != TCP_LENGTH) {
+			if (c == eot) {
+				if (box.fill) received(box, box.packet, box.fill);
+				box.fill = 0;
+				}
+			else if (c == slipesc) box.escape = true;
+			else {
+				if (box.escape) c = c == slipescend ? eot : slipesc;
+				box.escape = false;
+				if (box.fill < PACKET_MAX) box.packet[box.fill++] = c;
+				}
+			continue;
+			}
+		if (box.header < 4) {
+			box.length = (box.length << 8) | c;
+			if (++box.header == 4 && box.length == 0) box.header = 0;
+			continue;
+			}
+		if (box.fill < PACKET_MAX) box.packet[box.fill++] = c;
+		if (--box.length == 0) {
+			received(box, box.packet, box.fill);
+			box.fill = 0;
+			box.header = 0;
+			}
+		}
+	}
+
+Box *newBox(transport_t transport, int fd) {
+	for (int i = 0; i < BOXES_MAX; i++) {
+		if (boxes[i].used) continue;
+		Box &box = boxes[i];
+		memset(&box, 0, sizeof(Box));
+		box.used = true;
+		box.transport = transport;
+		box.fd = fd;
+		box.rxTime = nowMs();
+		return &box;
+		}
+	return NULL;
+	}
+
+void closeBox(Box &box) {
+	logLine("%s %s disconnected", transportName[box.transport], box.name);
+	if (box.transport != UDP) close(box.fd);
+	box.used = false;
+	}
+
+Box *udpBox(sockaddr_in &remote) {
+	for (int i = 0; i < BOXES_MAX; i++) {
+		Box &box = boxes[i];
+		if (box.used && box.transport == UDP && box.remote.sin_addr.s_addr == remote.sin_addr.s_addr && box.remote.sin_port == remote.sin_port) return &box;
+		}
+	Box *box = newBox(UDP, -1);
+	if (!box) return NULL;
+	box->remote = remote;
+	snprintf(box->name, sizeof(box->name), "%s:%u", inet_ntoa(remote.sin_addr), ntohs(remote.sin_port));
+	logLine("udp %s connected", box->name);
+	return box;
+	}
+
+/**
+ * @brief answer a DHCP discover with an offer and a request with an ack, a request of a renew too
+ *
+ */
+void dhcpReceive() {
+	uint8_t packet[PACKET_MAX];
+	sockaddr_in remote;
+	uint8_t control[64];
+	iovec iov = {packet, sizeof(packet)};
+	msghdr msg = {};
+	msg.msg_name = &remote;
+	msg.msg_namelen = sizeof(remote);
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	ssize_t size = recvmsg(dhcpSock, &msg, 0);
+	if (size < 240 || packet[0] != 1 || oscInt(packet + 236) != 0x63825363) return; // BOOTREQUEST with the magic cookie
+	uint8_t type = 0;
+	for (ssize_t i = 240; i + 2 < size && packet[i] != 255; i += packet[i] ? 2 + packet[i + 1] : 1) {
+		if (packet[i] == 53) type = packet[i + 2];
+		}
+	if (type != 1 && type != 3) return; // only DISCOVER and REQUEST
+	// the stand-in is the server, gateway and DNS server of the subnet on which the request came in
+	in_addr local = {htonl(INADDR_LOOPBACK)};
+	for (cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+		if (c->cmsg_level == IPPROTO_IP && c->cmsg_type == IP_PKTINFO) local = ((in_pktinfo*)CMSG_DATA(c))->ipi_spec_dst;
+		}
+	const uint8_t *mac = packet + 28;
+	int n = -1;
+	for (int i = 0; i < LEASES_MAX && n < 0; i++) {
+		if (leases[i].used && memcmp(leases[i].mac, mac, 6) == 0) n = i;
+		}
+	for (int i = 0; i < LEASES_MAX && n < 0; i++) {
+		if (!leases[i].used) {
+			n = i;
+			leases[i].used = true;
+			memcpy(leases[i].mac, mac, 6);
+			}
+		}
+	if (n < 0) return;
+	uint32_t address = htonl((ntohl(local.s_addr) & 0xFFFFFF00) | (101 + n));
+
+	uint8_t reply[300] = {};
+	memcpy(reply, packet, 12); // htype, hlen, hops, xid, secs and flags of the request
+	reply[0] = 2; // BOOTREPLY
+	memcpy(reply + 16, &address, 4); // yiaddr
+	memcpy(reply + 20, &local.s_addr, 4); // siaddr
+	memcpy(reply + 28, mac, 16); // chaddr
+	oscPutInt(reply + 236, 0x63825363);
+	uint8_t *o = reply + 240;
+	*o++ = 53; *o++ = 1; *o++ = type == 1 ? 2 : 5; // OFFER or ACK
+	*o++ = 54; *o++ = 4; memcpy(o, &local.s_addr, 4); o += 4; // server identifier
+	*o++ = 51; *o++ = 4; oscPutInt(o, leaseTime); o += 4;
+	*o++ = 58; *o++ = 4; oscPutInt(o, leaseTime / 2); o += 4; // T1
+	*o++ = 59; *o++ = 4; oscPutInt(o, leaseTime * 7 / 8); o += 4; // T2
+	*o++ = 1; *o++ = 4; oscPutInt(o, 0xFFFFFF00); o += 4; // subnet mask
+	*o++ = 3; *o++ = 4; memcpy(o, &local.s_addr, 4); o += 4; // router
+	*o++ = 6; *o++ = 4; memcpy(o, &local.s_addr, 4); o += 4; // DNS server
+	*o++ = 255;
+	// a box without an address is reached by a broadcast
+	if (remote.sin_addr.s_addr == htonl(INADDR_ANY)) remote.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+	sendto(dhcpSock, reply, o - reply, 0, (sockaddr*)&remote, sizeof(remote));
+	in_addr leased = {address};
+	logLine("dhcp %s %s for %02x:%02x:%02x:%02x:%02x:%02x, %us", type == 1 ? "offer" : "ack", inet_ntoa(leased),
+		mac[0], mac[1], mac[2], mac[3], mac[4], mac[5], leaseTime);
+	}
+
+int openSocket(int type, uint16_t port) {
+	int sock = socket(AF_INET, type, 0);
+	if (sock < 0) {
+		perror("socket");
+		exit(1);
+		}
+	int on = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	if (type == SOCK_DGRAM) setsockopt(sock, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+	sockaddr_in local = {};
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons(port);
+	if (bind(sock, (sockaddr*)&local, sizeof(local)) < 0) {
+		perror("bind");
+		exit(1);
+		}
+	if (type == SOCK_STREAM) listen(sock, BOXES_MAX);
+	return sock;
+	}
+
+void acceptClient(int server, transport_t framing) {
+	sockaddr_in remote;
+	socklen_t remoteSize = sizeof(remote);
+	int sock = accept(server, (sockaddr*)&remote, &remoteSize);
+	if (sock < 0) return;
+	Box *box = newBox(framing, sock);
+	if (!box) {
+		close(sock); // no free box
+		return;
+		}
+	int on = 1;
+	setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+	box->remote = remote;
+	snprintf(box->name, sizeof(box->name), "%s:%u", inet_ntoa(remote.sin_addr), ntohs(remote.sin_port));
+	logLine("%s %s connected", transportName[framing], box->name);
+	}
+
+/**
+ * @brief open the serial port of a USB box in raw mode
+ *
+ */
+Box *openSerial(const char *path) {
+	int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0) {
+		perror(path);
+		exit(1);
+		}
+	termios tio;
+	if (tcgetattr(fd, &tio) == 0) {
+		cfmakeraw(&tio);
+		cfsetspeed(&tio, B115200);
+		tcsetattr(fd, TCSANOW, &tio);
+		}
+	Box *box = newBox(SERIAL_SLIP, fd);
+	snprintf(box->name, sizeof(box->name), "%s", path);
+	return box;
+	}
+
+int main(int argc, char *argv[]) {
+	const char *serial = NULL;
+	int opt;
+	uint16_t dhcpPort = 0;
+	while ((opt = getopt(argc, argv, "qp:c:s:d:l:")) != -1) {
+		switch (opt) {
+			case 'q': quiet = true; break;
+			case 'p': paramRate = atof(optarg); break;
+			case 'c': cueRate = atof(optarg); break;
+			case 's': serial = optarg; break;
+			case 'd': dhcpPort = atoi(optarg); break;
+			case 'l': leaseTime = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage: %s [-q] [-p Hz] [-c Hz] [-s serial] [-d port] [-l s] [udp port] [tcp length port] [tcp slip port]\n", argv[0]);
+				return 1;
+			}
+		}
+	uint16_t port[3] = {8000, 3032, 3037};
+	for (int i = 0; i < 3 && optind < argc; i++, optind++) port[i] = atoi(argv[optind]);
+	udpSock = openSocket(SOCK_DGRAM, port[UDP]);
+	int tcpLength = openSocket(SOCK_STREAM, port[TCP_LENGTH]);
+	int tcpSlip = openSocket(SOCK_STREAM, port[TCP_SLIP]);
+	Box *serialBox = serial ? openSerial(serial) : NULL;
+	if (dhcpPort) {
+		dhcpSock = openSocket(SOCK_DGRAM, dhcpPort);
+		int on = 1;
+		setsockopt(dhcpSock, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on)); // the address on which a request came in
+		}
+	setvbuf(stdout, NULL, _IOLBF, 0);
+	fprintf(stderr, "EOS stand-in on UDP %u, TCP %u (length) and TCP %u (SLIP)%s%s\n", port[UDP], port[TCP_LENGTH], port[TCP_SLIP], serial ? " and " : "", serial ? serial : "");
+	if (dhcpPort) fprintf(stderr, "DHCP server on UDP %u, lease %us\n", dhcpPort, leaseTime);
+
+	uint64_t statsTime = nowMs();
+	uint64_t paramTime = statsTime;
+	uint64_t cueTime = statsTime;
+	uint64_t handshakeTime = 0;
+	while (true) {
+		pollfd fds[4 + BOXES_MAX];
+		Box *fdBox[4 + BOXES_MAX];
+		int n = 0;
+		fds[n++] = {udpSock, POLLIN, 0};
+		fds[n++] = {tcpLength, POLLIN, 0};
+		fds[n++] = {tcpSlip, POLLIN, 0};
+		fds[n++] = {dhcpSock, POLLIN, 0}; // ignored by poll() without DHCP
+		for (int i = 0; i < BOXES_MAX; i++) {
+			if (!boxes[i].used || boxes[i].transport == UDP) continue;
+			fdBox[n] = &boxes[i];
+			fds[n++] = {boxes[i].fd, POLLIN, 0};
+			}
+		poll(fds, n, 5);
+
+		if (fds[0].revents & POLLIN) {
+			uint8_t packet[PACKET_MAX];
+			sockaddr_in remote;
+			socklen_t remoteSize = sizeof(remote);
+			ssize_t size = recvfrom(udpSock, packet, sizeof(packet), 0, (sockaddr*)&remote, &remoteSize);
+			Box *box = size > 0 ? udpBox(remote) : NULL;
+			if (box) received(*box, packet, size);
+			}
+		if (fds[1].revents & POLLIN) acceptClient(tcpLength, TCP_LENGTH);
+		if (fds[2].revents & POLLIN) acceptClient(tcpSlip, TCP_SLIP);
+		if (fds[3].revents & POLLIN) dhcpReceive();
+		for (int f = 4; f < n; f++) {
+			if (!(fds[f].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+			Box &box = *fdBox[f];
+			uint8_t data[PACKET_MAX];
+			ssize_t size = read(box.fd, data, sizeof(data));
+			if (size > 0) streamReceive(box, data, size);
+			else {
+				if (&box == serialBox) serialBox = NULL; // the box has closed the pty
+				closeBox(box);
+				}
+			}
+
+		uint64_t now = nowMs();
+		// EOS asks a serial port until the box answers
+		if (serialBox && !serialBox->handshake && now - handshakeTime >= 1000) {
+			handshakeTime = now;
+			boxSend(*serialBox, (const uint8_t*)"ETCOSC?", 7);
+			}
+		for (int i = 0; i < BOXES_MAX; i++) {
+			if (boxes[i].used && boxes[i].transport == UDP && now - boxes[i].rxTime > UDP_TIMEOUT_MS) closeBox(boxes[i]);
+			}
+		if (paramRate > 0 && now - paramTime >= 1000 / paramRate) {
+			paramTime = now;
+			// a running effect, the values move around the value of the console
+			float phase = sin(now / 1000.0);
+			for (uint8_t i = 0; i < paramCount; i++) paramOut(params[i], params[i].value + phase * (params[i].max - params[i].min) / 100);
+			}
+		if (cueRate > 0 && now - cueTime >= 1000 / cueRate) {
+			cueTime = now;
+			if (cuePercent < 100) cuePercent += 100 / (5 * cueRate); // a fade of 5s
+			if (cuePercent > 100) cuePercent = 100;
+			cueOut();
+			}
+		if (now - statsTime >= 1000) {
+			for (int t = 0; t < 4; t++) {
+				if (stats[t].packets == 0 && stats[t].sent == 0) continue;
+				fprintf(stderr, "%s: %u packets/s, %u bytes/s in, %u messages/s out\n", transportName[t], stats[t].packets, stats[t].bytes, stats[t].sent);
+				stats[t].packets = stats[t].bytes = stats[t].sent = 0;
+				}
+			statsTime = now;
+			}
+		}
+	}